@@ -6,11 +6,23 @@
 
 #include <QApplication>
 
+#include "SessionStore.h"
+#include "SingleIstance.h"
+
 AppManager::AppManager(QObject *parent) : QObject(parent), m_isStartingUp(true) {
 
 }
 
 void AppManager::start() {
+	// Una sessione salvata si riapre subito, senza chiedere la dimensione
+	const QByteArray session = SessionStore().load();
+	const int mode = MainWindow::sessionMode(session);
+	if (mode > 0) {
+		createMainWindow(mode);
+		m_mainWindow->restoreSession(session);
+		return;
+	}
+
 	showModeSelection();
 }
 
@@ -28,6 +40,13 @@ void AppManager::showModeSelection() {
 	m_startupDialog->show();
 }
 
+void AppManager::activate() {
+	if (m_mainWindow)
+		SingleInstance::activateWindow(m_mainWindow);
+	else if (m_startupDialog)
+		SingleInstance::activateWindow(m_startupDialog);
+}
+
 /*
  * Dialog OK: lo elimina e chiama il crea finestra col suo risultato
  */
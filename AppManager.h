@@ -20,6 +20,9 @@ public:
 
 	void showModeSelection();
 
+	/** Raises the open window (or the mode dialog), e.g. when a second launch asks for it. */
+	void activate();
+
 private slots:
 	void onMainWindowClosed();
 	void onModeSelected();
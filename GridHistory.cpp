@@ -0,0 +1,186 @@
+#include "GridHistory.h"
+
+#include <algorithm>
+#include <utility>
+
+// === EditHistory ===
+EditHistory::EditHistory(size_t maxDeltas, std::chrono::milliseconds mergeWindow)
+    : maxDeltas(maxDeltas)
+    , mergeWindow(mergeWindow)
+{
+}
+
+void EditHistory::record(int cell, unsigned short before, unsigned short after)
+{
+    if (before == after)
+        return;
+
+    // Una modifica nuova rende impossibile rifare quelle annullate
+    if (cursor < groupStart.size()) {
+        deltas.resize(groupStart[cursor]);
+        groupStart.resize(cursor);
+        groupSolved.resize(cursor);
+        groupOpen = false;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (!groupOpen || now - lastEdit > mergeWindow) {
+        groupStart.push_back(static_cast<uint32_t>(deltas.size()));
+        groupSolved.emplace_back();
+        cursor = groupStart.size();
+        groupOpen = true;
+    }
+    lastEdit = now;
+
+    // Nel gruppo ogni cella compare una volta: si aggiorna solo il valore finale
+    const auto first = deltas.begin() + groupStart.back();
+    const auto it = std::find_if(first, deltas.end(), [cell](const GridDelta &d) { return d.cell == cell; });
+    if (it == deltas.end()) {
+        deltas.push_back({static_cast<uint16_t>(cell), static_cast<uint8_t>(before), static_cast<uint8_t>(after)});
+        trim();
+        return;
+    }
+
+    it->after = static_cast<uint8_t>(after);
+    if (it->before == it->after)
+        deltas.erase(it);
+
+    // la cella è tornata com'era e il gruppo è vuoto: non c'è niente da annullare
+    if (deltas.size() == groupStart.back()) {
+        groupStart.pop_back();
+        groupSolved.pop_back();
+        cursor = groupStart.size();
+        groupOpen = false;
+    }
+}
+
+void EditHistory::closeGroup()
+{
+    groupOpen = false;
+}
+
+void EditHistory::markSolve(SolverState state)
+{
+    if (!groupSolved.empty())
+        groupSolved.back() = std::move(state);
+}
+
+HistoryGroup EditHistory::undo()
+{
+    closeGroup();
+    if (!canUndo())
+        return {};
+    return group(--cursor);
+}
+
+HistoryGroup EditHistory::redo()
+{
+    closeGroup();
+    if (!canRedo())
+        return {};
+    return group(cursor++);
+}
+
+void EditHistory::clear()
+{
+    deltas.clear();
+    groupStart.clear();
+    groupSolved.clear();
+    cursor = 0;
+    groupOpen = false;
+}
+
+HistoryGroup EditHistory::group(size_t index) const
+{
+    const size_t begin = groupStart[index];
+    const size_t end = index + 1 < groupStart.size() ? groupStart[index + 1] : deltas.size();
+    const SolverState &solved = groupSolved[index];
+    return {std::span<const GridDelta>(deltas.data() + begin, end - begin), solved.dimension() ? &solved : nullptr};
+}
+
+void EditHistory::trim()
+{
+    if (deltas.size() <= maxDeltas)
+        return;
+
+    // Si scartano i gruppi più vecchi fino a 3/4 del budget, così lo spostamento
+    // del vettore si paga di rado; il gruppo in corso resta sempre
+    const size_t goal = maxDeltas / 4 * 3;
+    size_t drop = 0;
+    while (drop + 1 < groupStart.size() && deltas.size() - groupStart[drop] > goal)
+        ++drop;
+    if (drop == 0)
+        return;
+
+    const uint32_t offset = groupStart[drop];
+    deltas.erase(deltas.begin(), deltas.begin() + offset);
+    groupStart.erase(groupStart.begin(), groupStart.begin() + static_cast<std::ptrdiff_t>(drop));
+    groupSolved.erase(groupSolved.begin(), groupSolved.begin() + static_cast<std::ptrdiff_t>(drop));
+    for (uint32_t &start : groupStart)
+        start -= offset;
+    cursor -= std::min(cursor, drop);
+}
+
+// === SolveRecording ===
+SolveRecording::SolveRecording(size_t maxSteps)
+    : maxSteps(maxSteps)
+{
+}
+
+void SolveRecording::start(unsigned short dimension, std::vector<uint8_t> grid)
+{
+    dim = dimension;
+    values = std::move(grid);
+    deltas.clear();
+    cursor = 0;
+    dropped = 0;
+}
+
+void SolveRecording::append(std::span<const ProgressStep> steps)
+{
+    for (const ProgressStep &step : steps) {
+        const int cell = step.row * dim + step.column;
+        deltas.push_back({static_cast<uint16_t>(cell), values[cell], static_cast<uint8_t>(step.value)});
+        values[cell] = static_cast<uint8_t>(step.value);
+    }
+
+    // Oltre il budget si dimentica il quarto più vecchio dei passi
+    if (deltas.size() > maxSteps) {
+        const size_t drop = deltas.size() - maxSteps / 4 * 3;
+        deltas.erase(deltas.begin(), deltas.begin() + static_cast<std::ptrdiff_t>(drop));
+        dropped += drop;
+    }
+    cursor = deltas.size();
+}
+
+void SolveRecording::clear()
+{
+    values.clear();
+    values.shrink_to_fit();
+    deltas.clear();
+    deltas.shrink_to_fit();
+    cursor = 0;
+    dropped = 0;
+}
+
+bool SolveRecording::seek(size_t target, std::vector<ProgressStep> &out)
+{
+    out.clear();
+    target = std::min(target, deltas.size());
+    if (target == cursor)
+        return false;
+
+    // Indietro si rimette il valore precedente, avanti quello nuovo
+    auto push = [&](const GridDelta &d, uint8_t value) {
+        out.push_back({static_cast<unsigned short>(d.cell / dim), static_cast<unsigned short>(d.cell % dim), value});
+    };
+    if (target < cursor)
+        for (size_t i = cursor; i-- > target;)
+            push(deltas[i], deltas[i].before);
+    else
+        for (size_t i = cursor; i < target; ++i)
+            push(deltas[i], deltas[i].after);
+
+    cursor = target;
+    return true;
+}
@@ -0,0 +1,167 @@
+#ifndef GRIDHISTORY_H
+#define GRIDHISTORY_H
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "libs/SudokuSolverAlgorithm.h"
+
+/**
+ * @brief One change of one cell: 4 bytes, whatever the grid size.
+ *
+ * Cells are row-major indices (at most 36 * 36) and values fit a byte, so a
+ * history stores deltas instead of whole grids.
+ */
+struct GridDelta {
+    uint16_t cell;
+    uint8_t before;
+    uint8_t after;
+};
+
+/** @brief A group returned by `EditHistory::undo()` or `EditHistory::redo()`. */
+struct HistoryGroup {
+    std::span<const GridDelta> deltas;
+    /** Solver state at the end of a solve group (see `markSolve()`); null for other groups. */
+    const SolverState *solved = nullptr;
+};
+
+/**
+ * @brief Undo/redo history of the grid edits, as groups of deltas.
+ *
+ * Every edit is recorded as (cell, old value, new value). Edits recorded
+ * within `mergeWindow` of each other fall in the same group, so a burst of
+ * keystrokes is undone in one step; `closeGroup()` forces a boundary (hints,
+ * resets, solves). Inside a group each cell appears once, with its value
+ * before the group and after it. A solve group also keeps the solver state it
+ * ended with, so redoing it shows the solution again instead of turning the
+ * solved values into clues.
+ *
+ * Memory is bounded: past `maxDeltas` deltas the oldest groups are dropped.
+ */
+class EditHistory {
+public:
+    /**
+     * @brief Creates an empty history.
+     * @param maxDeltas Deltas kept at most; older groups are forgotten.
+     * @param mergeWindow Longest pause between two edits of the same group.
+     */
+    explicit EditHistory(size_t maxDeltas = size_t(1) << 18,
+                         std::chrono::milliseconds mergeWindow = std::chrono::milliseconds(1000));
+
+    /**
+     * @brief Records an edit; undone edits that could be redone are discarded.
+     * @param cell Row-major index of the cell.
+     * @param before Value before the edit.
+     * @param after Value after the edit.
+     */
+    void record(int cell, unsigned short before, unsigned short after);
+    /** @brief Ends the current group: the next edit starts a new one. */
+    void closeGroup();
+    /**
+     * @brief Marks the last group as a solve.
+     * @param state Solver state showing the solution, put back when the group is redone.
+     */
+    void markSolve(SolverState state);
+
+    /** @brief true if there is a group to undo. */
+    [[nodiscard]] bool canUndo() const { return cursor > 0; }
+    /** @brief true if there is a group to redo. */
+    [[nodiscard]] bool canRedo() const { return cursor < groupStart.size(); }
+    /**
+     * @brief Steps back one group.
+     * @return The group; the caller puts back each `before`.
+     *         Valid until the next call that changes the history.
+     */
+    HistoryGroup undo();
+    /**
+     * @brief Steps forward one group.
+     * @return The group; the caller applies each `after`.
+     */
+    HistoryGroup redo();
+
+    /** @brief Forgets every group. */
+    void clear();
+    /** @brief Number of deltas stored (undo and redo). */
+    [[nodiscard]] size_t deltaCount() const { return deltas.size(); }
+
+private:
+    /** @brief Deltas and solve state of group `index`. */
+    [[nodiscard]] HistoryGroup group(size_t index) const;
+    /** @brief Drops the oldest groups once the history is over its budget. */
+    void trim();
+
+    /** Deltas of every group, oldest first. */
+    std::vector<GridDelta> deltas;
+    /** Index in `deltas` of the first delta of each group. */
+    std::vector<uint32_t> groupStart;
+    /** Final solver state of each solve group; of dimension 0 for the other groups. */
+    std::vector<SolverState> groupSolved;
+    /** Groups [0, cursor) are applied; the others can be redone. */
+    size_t cursor = 0;
+    /** true while edits can still merge into the last group. */
+    bool groupOpen = false;
+    /** Time of the last edit, for merging. */
+    std::chrono::steady_clock::time_point lastEdit;
+
+    size_t maxDeltas;
+    std::chrono::milliseconds mergeWindow;
+};
+
+/**
+ * @brief The steps of the last solve as deltas, to step through it afterwards.
+ *
+ * Fed with the same steps that drive the solve animation; each step becomes a
+ * delta against the grid left by the previous one, so the recording can be
+ * walked forward and backward from any point.
+ *
+ * Memory is bounded: past `maxSteps` steps the oldest quarter is dropped, and
+ * stepping back stops at the oldest step still kept.
+ */
+class SolveRecording {
+public:
+    using ProgressStep = SudokuSolverAlgorithm::ProgressStep;
+
+    /** @param maxSteps Steps kept at most (4 bytes each). */
+    explicit SolveRecording(size_t maxSteps = size_t(1) << 22);
+
+    /**
+     * @brief Starts a new recording.
+     * @param dimension Grid size.
+     * @param values Grid shown when the solve starts, row-major.
+     */
+    void start(unsigned short dimension, std::vector<uint8_t> values);
+    /** @brief Appends steps of the running solve; the position follows the last one. */
+    void append(std::span<const ProgressStep> steps);
+    /** @brief Forgets the recording. */
+    void clear();
+
+    /**
+     * @brief Moves to a step, producing what to show on the way.
+     * @param target Step to move to, clamped to the recording.
+     * @param out Receives the cell changes to apply in order (cleared first).
+     * @return true if the position changed.
+     */
+    bool seek(size_t target, std::vector<ProgressStep> &out);
+
+    /** @brief Steps kept. */
+    [[nodiscard]] size_t size() const { return deltas.size(); }
+    /** @brief Steps applied to the grid shown, in [0, size()]. */
+    [[nodiscard]] size_t position() const { return cursor; }
+    /** @brief true when the grid shows the end of the solve. */
+    [[nodiscard]] bool atEnd() const { return cursor == deltas.size(); }
+    /** @brief Oldest steps dropped to stay within the budget. */
+    [[nodiscard]] size_t droppedSteps() const { return dropped; }
+
+private:
+    unsigned short dim = 0;
+    /** Grid after the last appended step, for the `before` of the next ones. */
+    std::vector<uint8_t> values;
+    std::vector<GridDelta> deltas;
+    size_t cursor = 0;
+    size_t dropped = 0;
+    size_t maxSteps;
+};
+
+#endif // GRIDHISTORY_H
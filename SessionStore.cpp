@@ -0,0 +1,81 @@
+#include "SessionStore.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+SessionStore::SessionStore(QString p)
+    : path(std::move(p))
+{
+    pool.setMaxThreadCount(1);
+}
+
+SessionStore::~SessionStore()
+{
+    pool.waitForDone();
+}
+
+QString SessionStore::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/session.bin";
+}
+
+void SessionStore::saveAsync(const QByteArray &data)
+{
+    QMutexLocker lock(&mutex);
+
+    // Una scrittura è già in coda: prenderà questi dati al posto dei vecchi
+    const bool scheduled = pending.has_value();
+    pending = data;
+    if (scheduled)
+        return;
+
+    pool.start([this]() {
+        QByteArray bytes;
+        {
+            QMutexLocker lock(&mutex);
+            // save() può aver già scritto al posto nostro
+            if (!pending)
+                return;
+            bytes = std::move(*pending);
+            pending.reset();
+        }
+        write(bytes);
+    });
+}
+
+bool SessionStore::save(const QByteArray &data)
+{
+    {
+        QMutexLocker lock(&mutex);
+        pending.reset();
+    }
+    // la scrittura in corso finisce prima, così non sovrascrive questa
+    pool.waitForDone();
+    return write(data);
+}
+
+QByteArray SessionStore::load() const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return file.readAll();
+}
+
+bool SessionStore::write(const QByteArray &data) const
+{
+    if (data.isNull())
+        return !QFile::exists(path) || QFile::remove(path);
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    // QSaveFile scrive su un file temporaneo e lo rinomina solo a scrittura completata
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(data);
+    return file.commit();
+}
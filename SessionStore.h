@@ -0,0 +1,62 @@
+#ifndef SESSIONSTORE_H
+#define SESSIONSTORE_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QThreadPool>
+
+#include <optional>
+
+/**
+ * @brief Session file on disk, written atomically on a background thread.
+ *
+ * `saveAsync()` only hands the bytes over: the file is written by a private
+ * thread through QSaveFile, so a crash mid-write leaves the previous session
+ * intact. Saves requested while a write is running are coalesced and only the
+ * latest one is written.
+ */
+class SessionStore
+{
+public:
+    /**
+     * @brief Store for a session file.
+     * @param path File to use; by default `session.bin` in the application data folder.
+     */
+    explicit SessionStore(QString path = defaultPath());
+    /** @brief Waits for the pending write, so the last save is never lost. */
+    ~SessionStore();
+
+    SessionStore(const SessionStore&) = delete;
+    SessionStore& operator=(const SessionStore&) = delete;
+
+    /** @brief `session.bin` in the writable application data folder. */
+    static QString defaultPath();
+
+    /**
+     * @brief Writes the session in the background.
+     * @param data Bytes to write; a null array removes the file instead.
+     */
+    void saveAsync(const QByteArray &data);
+    /**
+     * @brief Writes the session now, after any pending background write.
+     * @param data Bytes to write; a null array removes the file instead.
+     * @return false if the file could not be written.
+     */
+    bool save(const QByteArray &data);
+    /** @brief Contents of the session file; empty if there is none. */
+    [[nodiscard]] QByteArray load() const;
+
+private:
+    /** @brief Writes (or removes) the file; runs on the store's thread or in `save()`. */
+    bool write(const QByteArray &data) const;
+
+    QString path;
+    /** One thread: writes never overlap. */
+    QThreadPool pool;
+    QMutex mutex;
+    /** Latest bytes not written yet; guarded by `mutex`. */
+    std::optional<QByteArray> pending;
+};
+
+#endif // SESSIONSTORE_H
@@ -3,17 +3,62 @@
 //
 
 #include "SingleIstance.h"
+#include <QDeadlineTimer>
 #include <QDebug>
+#include <QThread>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "libs/SudokuSolverAlgorithm.h"
 
 #ifdef Q_OS_WIN
 #include <windows.h>
 #endif
 
+namespace {
+
+constexpr quint32 ringMagic = 0x524B4453;       // "SDKR"
+constexpr quint32 ringVersion = 1;
+constexpr int ringSlots = 16;
+constexpr int slotCells = SingleInstance::maxDimension * SingleInstance::maxDimension;
+
+enum SlotState : quint32 {
+	Free,
+	Submitted,
+	Running,
+	Done,
+	Abandoned       // Il chiamante ha smesso di aspettare: il primario libera lo slot a fine lavoro
+};
+
+struct JobSlot {
+	quint32 state;
+	/** Ordine di arrivo: il primario serve per primo il lavoro più vecchio. */
+	quint32 sequence;
+	/** 0 per una richiesta di attivazione della finestra. */
+	quint16 dimension;
+	qint16 status;
+	quint16 cells[slotCells];
+};
+
+struct JobRing {
+	quint32 magic;
+	quint32 version;
+	quint32 slotCount;
+	quint32 nextSequence;
+	JobSlot slots[ringSlots];
+};
+
+static_assert(std::is_trivially_copyable_v<JobRing>, "the ring is shared between processes as raw memory");
+
+}
+
 SingleInstance::SingleInstance(const QString &key, QWidget *mainWindow, QObject *parent)
 	: QObject(parent)
 	, m_key(key)
 	, m_sharedMemory(key)
 	, m_semaphore(key + "_semaphore", 1)
+	, m_jobsAvailable(key + "_jobs", 0)
 	, m_mainWindow(mainWindow)
 	, m_isPrimary(false)
 {
@@ -23,22 +68,58 @@ SingleInstance::SingleInstance(const QString &key, QWidget *mainWindow, QObject
 		// Esiste già un'istanza
 		m_semaphore.release();
 		m_isPrimary = false;
+		m_hasRing = attachRing();
 
 		// Attiva la finestra esistente
 		if (m_mainWindow) {
 			activateWindow(m_mainWindow);
 		}
 	} else {
-		// Prima istanza
-		if (m_sharedMemory.create(1)) {
+		// Prima istanza: il segmento contiene l'anello dei lavori, inizializzato prima che altri possano agganciarsi
+		if (m_sharedMemory.create(sizeof(JobRing))) {
 			m_isPrimary = true;
+
+			auto *ring = static_cast<JobRing*>(m_sharedMemory.data());
+			std::memset(ring, 0, sizeof(JobRing));
+			ring->magic = ringMagic;
+			ring->version = ringVersion;
+			ring->slotCount = ringSlots;
+
+			// Create azzera anche i conteggi rimasti da un'istanza terminata male
+			m_jobsAvailable.setKey(m_key + "_jobs", 0, QSystemSemaphore::Create);
+			m_hasRing = true;
 		}
 		m_semaphore.release();
+
+		if (m_isPrimary) {
+			m_listener = QThread::create([this] { listen(); });
+			m_listener->start();
+		}
 	}
 }
 
 SingleInstance::~SingleInstance()
 {
+	if (m_listener) {
+		m_stopping = true;
+		if (SudokuSolverAlgorithm *solver = m_running.load())
+			solver->requestStop();
+		m_jobsAvailable.release();
+		m_listener->wait();
+		delete m_listener;
+
+		// I lavori rimasti in coda non verranno serviti: chi aspetta lo sa subito
+		m_sharedMemory.lock();
+		auto *ring = static_cast<JobRing*>(m_sharedMemory.data());
+		for (JobSlot &slot : ring->slots) {
+			if (slot.state == Submitted) {
+				slot.status = static_cast<qint16>(JobStatus::Unavailable);
+				slot.state = Done;
+			}
+		}
+		m_sharedMemory.unlock();
+	}
+
 	if (m_isPrimary) {
 		m_semaphore.acquire();
 		m_sharedMemory.detach();
@@ -46,6 +127,194 @@ SingleInstance::~SingleInstance()
 	}
 }
 
+/*
+ * Istanza secondaria: controlla che il primario esponga un anello di questa versione
+ */
+bool SingleInstance::attachRing()
+{
+	if (m_sharedMemory.size() < static_cast<qsizetype>(sizeof(JobRing)))
+		return false;
+
+	m_sharedMemory.lock();
+	const auto *ring = static_cast<const JobRing*>(m_sharedMemory.constData());
+	const bool compatible = ring->magic == ringMagic && ring->version == ringVersion && ring->slotCount == ringSlots;
+	m_sharedMemory.unlock();
+	return compatible;
+}
+
+/*
+ * Scrive un lavoro nel primo slot libero, partendo dal successivo dell'anello.
+ * Restituisce l'indice dello slot o -1 se sono tutti occupati.
+ */
+int SingleInstance::claimSlot(quint16 dimension, const QVector<quint16> &cells)
+{
+	m_sharedMemory.lock();
+	auto *ring = static_cast<JobRing*>(m_sharedMemory.data());
+
+	int claimed = -1;
+	for (int i = 0; i < ringSlots && claimed < 0; i++) {
+		const int index = static_cast<int>((ring->nextSequence + i) % ringSlots);
+		JobSlot &slot = ring->slots[index];
+		if (slot.state != Free)
+			continue;
+
+		slot.sequence = ring->nextSequence++;
+		slot.dimension = dimension;
+		slot.status = 0;
+		std::copy(cells.cbegin(), cells.cend(), slot.cells);
+		slot.state = Submitted;
+		claimed = index;
+	}
+
+	m_sharedMemory.unlock();
+	return claimed;
+}
+
+SingleInstance::JobResult SingleInstance::submit(const QVector<quint16> &cells, quint16 dimension, int timeoutMs)
+{
+	JobResult result;
+	if (m_isPrimary || !m_hasRing)
+		return result;
+
+	if (dimension == 0 || dimension > maxDimension || cells.size() != static_cast<qsizetype>(dimension) * dimension) {
+		result.status = JobStatus::Invalid;
+		return result;
+	}
+
+	const QDeadlineTimer deadline(timeoutMs);
+	int index;
+	while ((index = claimSlot(dimension, cells)) < 0) {
+		if (deadline.hasExpired()) {
+			result.status = JobStatus::TimedOut;
+			return result;
+		}
+		QThread::msleep(2);
+	}
+	m_jobsAvailable.release();
+
+	// Lo slot è nostro finché non lo rimettiamo libero: basta controllarne lo stato
+	while (true) {
+		m_sharedMemory.lock();
+		JobSlot &slot = static_cast<JobRing*>(m_sharedMemory.data())->slots[index];
+		if (slot.state == Done) {
+			result.status = static_cast<JobStatus>(slot.status);
+			if (result.status == JobStatus::Solved)
+				result.cells = QVector<quint16>(slot.cells, slot.cells + cells.size());
+			slot.state = Free;
+			m_sharedMemory.unlock();
+			return result;
+		}
+		if (deadline.hasExpired()) {
+			// Se non è ancora partito lo slot si libera subito, altrimenti lo libera il primario
+			slot.state = slot.state == Submitted ? Free : Abandoned;
+			m_sharedMemory.unlock();
+			result.status = JobStatus::TimedOut;
+			return result;
+		}
+		m_sharedMemory.unlock();
+		QThread::msleep(1);
+	}
+}
+
+bool SingleInstance::requestActivation()
+{
+	if (m_isPrimary || !m_hasRing || claimSlot(0, {}) < 0)
+		return false;
+
+	m_jobsAvailable.release();
+	return true;
+}
+
+/*
+ * Thread del primario: dorme sul semaforo dei lavori e svuota l'anello a ogni risveglio.
+ * I solver restano vivi tra un lavoro e l'altro, uno per dimensione.
+ */
+void SingleInstance::listen()
+{
+	std::map<quint16, std::unique_ptr<SudokuSolverAlgorithm>> solvers;
+
+	while (!m_stopping) {
+		m_jobsAvailable.acquire();
+		while (!m_stopping && processNextJob(solvers)) {
+		}
+	}
+}
+
+bool SingleInstance::processNextJob(std::map<quint16, std::unique_ptr<SudokuSolverAlgorithm>> &solvers)
+{
+	m_sharedMemory.lock();
+	auto *ring = static_cast<JobRing*>(m_sharedMemory.data());
+
+	JobSlot *slot = nullptr;
+	for (JobSlot &candidate : ring->slots) {
+		// Confronto circolare: regge anche quando il contatore riparte da zero
+		if (candidate.state == Submitted
+			&& (!slot || static_cast<qint32>(candidate.sequence - slot->sequence) < 0))
+			slot = &candidate;
+	}
+	if (!slot) {
+		m_sharedMemory.unlock();
+		return false;
+	}
+
+	const quint16 dimension = slot->dimension;
+	if (dimension == 0) {
+		slot->state = Free;
+		m_sharedMemory.unlock();
+		emit activationRequested();
+		return true;
+	}
+
+	// La dimensione viene da un altro processo: oltre il massimo la griglia non sta nello slot
+	const size_t cellCount = dimension <= maxDimension ? static_cast<size_t>(dimension) * dimension : 0;
+	const std::vector<unsigned short> cells(slot->cells, slot->cells + cellCount);
+	slot->state = Running;
+	m_sharedMemory.unlock();
+
+	JobStatus status = JobStatus::Invalid;
+	std::vector<unsigned short> solution;
+	quint16 block = 1;
+	while (block * block < dimension)
+		block++;
+
+	if (cellCount > 0 && block * block == dimension) {
+		std::unique_ptr<SudokuSolverAlgorithm> &solver = solvers[dimension];
+		if (!solver) {
+			solver = std::make_unique<SudokuSolverAlgorithm>(dimension);
+			solver->setProgressRecording(false);
+		}
+
+		// Griglie indipendenti: la soluzione del lavoro precedente non serve da partenza
+		solver->clean();
+		if (solver->load(cells).empty()) {
+			m_running = solver.get();
+			if (m_stopping)
+				solver->requestStop();
+			const bool solved = solver->solve();
+			m_running = nullptr;
+
+			if (solved) {
+				solution.resize(cells.size());
+				solver->store(solution);
+				status = JobStatus::Solved;
+			} else {
+				status = m_stopping ? JobStatus::Unavailable : JobStatus::Unsolvable;
+			}
+		}
+	}
+
+	m_sharedMemory.lock();
+	if (slot->state == Abandoned) {
+		slot->state = Free;
+	} else {
+		slot->status = static_cast<qint16>(status);
+		std::copy(solution.cbegin(), solution.cend(), slot->cells);
+		slot->state = Done;
+	}
+	m_sharedMemory.unlock();
+	return true;
+}
+
 void SingleInstance::activateWindow(QWidget *window)
 {
 	if (!window) return;
@@ -67,4 +336,4 @@ void SingleInstance::activateWindow(QWidget *window)
 #endif
 
 	qDebug() << "Finestra attivata";
-}
\ No newline at end of file
+}
@@ -7,27 +7,90 @@
 
 #include <QSharedMemory>
 #include <QSystemSemaphore>
+#include <QVector>
 #include <QWidget>
+#include <atomic>
+#include <map>
+#include <memory>
 
+class QThread;
+class SudokuSolverAlgorithm;
+
+/**
+ * Keeps a single running instance and lets later launches hand it work.
+ *
+ * The shared memory segment holds a ring of job slots. A secondary instance
+ * (e.g. `SudokuSolver puzzle.txt`) writes a grid into a free slot, signals the
+ * jobs semaphore and waits for the slot to be marked done; the primary
+ * instance solves it on a background thread with a solver kept per dimension
+ * and writes the solution back into the same slot. No files or sockets are
+ * involved. A secondary launch without puzzles sends an activation job, so
+ * the running window is raised.
+ */
 class SingleInstance : public QObject
 {
 	Q_OBJECT
 
 public:
+	/** Outcome of a job, as written back by the primary instance. */
+	enum class JobStatus : qint16 {
+		Solved,
+		Unsolvable,
+		Invalid,        ///< Bad dimension or conflicting clues
+		TimedOut,       ///< Not answered in time; the job was withdrawn
+		Unavailable     ///< No primary instance, or one without the job ring
+	};
+
+	struct JobResult {
+		JobStatus status = JobStatus::Unavailable;
+		/** Solution, row-major, when `status` is Solved. */
+		QVector<quint16> cells;
+	};
+
+	/** Largest grid that fits in a slot: 36x36, the last one with one symbol per value. */
+	static constexpr int maxDimension = 36;
+
 	explicit SingleInstance(const QString &key, QWidget *mainWindow = nullptr, QObject *parent = nullptr);
 	~SingleInstance() override;
 
 	[[nodiscard]] bool isPrimaryInstance() const { return m_isPrimary; }
 
+	/**
+	 * Secondary instance: hands a grid to the primary and waits for the solution.
+	 * @param cells Row-major clues, `dimension * dimension` values, 0 for empty cells.
+	 * @param timeoutMs Time to wait for a free slot and for the answer.
+	 */
+	JobResult submit(const QVector<quint16> &cells, quint16 dimension, int timeoutMs = 30000);
+
+	/** Secondary instance: asks the primary to raise its window. */
+	bool requestActivation();
+
 	static void activateWindow(QWidget *window);
 
+signals:
+	/** A secondary launch asked for the window (emitted on the listener thread). */
+	void activationRequested();
+
 private:
+	bool attachRing();
+	int claimSlot(quint16 dimension, const QVector<quint16> &cells);
+	void listen();
+	bool processNextJob(std::map<quint16, std::unique_ptr<SudokuSolverAlgorithm>> &solvers);
+
 	QString m_key;
 	QSharedMemory m_sharedMemory;
 	QSystemSemaphore m_semaphore;
+	/** Counts the jobs written into the ring and not yet picked up. */
+	QSystemSemaphore m_jobsAvailable;
 	QWidget *m_mainWindow;
 	bool m_isPrimary;
+	bool m_hasRing = false;
+
+	QThread *m_listener = nullptr;
+	std::atomic<bool> m_stopping{false};
+	/** Solver of the job being solved, so the destructor can stop it. */
+	std::atomic<SudokuSolverAlgorithm*> m_running{nullptr};
 };
 
 
-#endif //SUDOKUSOLVER_SINGLEISTANCE_H
\ No newline at end of file
+#endif //SUDOKUSOLVER_SINGLEISTANCE_H
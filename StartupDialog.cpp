@@ -11,7 +11,7 @@
 #include <QButtonGroup>
 
 StartupDialog::StartupDialog(QWidget *parent) : QDialog(parent) {
-	setFixedSize(200, 125);
+	setFixedSize(200, 175);
 	setWindowTitle("Seleziona modalità di avvio");
 
 	QVBoxLayout *layout = new QVBoxLayout(this);
@@ -21,14 +21,20 @@ StartupDialog::StartupDialog(QWidget *parent) : QDialog(parent) {
 
 	QRadioButton *mode1 = new QRadioButton("3 x 3");
 	QRadioButton *mode2 = new QRadioButton("4 x 4");
+	QRadioButton *mode3 = new QRadioButton("5 x 5");
+	QRadioButton *mode4 = new QRadioButton("6 x 6");
 
 	radioGroup->addButton(mode1, 1);
 	radioGroup->addButton(mode2, 2);
+	radioGroup->addButton(mode3, 3);
+	radioGroup->addButton(mode4, 4);
 
 	mode1->setChecked(true);
 
 	layout->addWidget(mode1);
 	layout->addWidget(mode2);
+	layout->addWidget(mode3);
+	layout->addWidget(mode4);
 
 	QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
 	layout->addWidget(buttonBox);
@@ -15,6 +15,7 @@ class StartupDialog : public QDialog
 
 public:
 	explicit StartupDialog(QWidget *parent = nullptr);
+	// Modalità scelta: 1 = blocchi 3x3 (9x9), 2 = 4x4 (16x16), 3 = 5x5 (25x25), 4 = 6x6 (36x36)
 	int getSelectedMode() const;
 
 private:
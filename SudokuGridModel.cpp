@@ -0,0 +1,108 @@
+#include "SudokuGridModel.h"
+
+#include <cmath>
+
+SudokuGridModel::SudokuGridModel(unsigned short dimension, QObject *parent)
+    : QObject(parent)
+    , dim(dimension)
+    , block(static_cast<unsigned short>(std::sqrt(dimension)))
+    , values(dimension * dimension, 0)
+    , cellFlags(dimension * dimension, NoFlag)
+    , pendingMark(dimension * dimension, false)
+{
+}
+
+unsigned short SudokuGridModel::value(unsigned short row, unsigned short col) const
+{
+    return values[row * dim + col];
+}
+
+quint8 SudokuGridModel::flags(unsigned short row, unsigned short col) const
+{
+    return cellFlags[row * dim + col];
+}
+
+bool SudokuGridModel::hasFlag(unsigned short row, unsigned short col, CellFlag flag) const
+{
+    return cellFlags[row * dim + col] & flag;
+}
+
+void SudokuGridModel::setCell(unsigned short row, unsigned short col, unsigned short value, quint8 flags)
+{
+    const int index = row * dim + col;
+    if (values[index] == value && cellFlags[index] == flags)
+        return;
+
+    values[index] = value;
+    cellFlags[index] = flags;
+    touch(index);
+}
+
+void SudokuGridModel::setValue(unsigned short row, unsigned short col, unsigned short value)
+{
+    setCell(row, col, value, flags(row, col));
+}
+
+void SudokuGridModel::setFlag(unsigned short row, unsigned short col, CellFlag flag, bool on)
+{
+    const quint8 current = flags(row, col);
+    setCell(row, col, value(row, col), static_cast<quint8>(on ? (current | flag) : (current & ~flag)));
+}
+
+void SudokuGridModel::clearFlag(CellFlag flag)
+{
+    beginUpdate();
+    for (int i = 0; i < cellFlags.size(); ++i)
+        if (cellFlags[i] & flag) {
+            cellFlags[i] &= ~flag;
+            touch(i);
+        }
+    endUpdate();
+}
+
+void SudokuGridModel::clear()
+{
+    beginUpdate();
+    for (int i = 0; i < values.size(); ++i)
+        if (values[i] || cellFlags[i]) {
+            values[i] = 0;
+            cellFlags[i] = NoFlag;
+            touch(i);
+        }
+    endUpdate();
+}
+
+void SudokuGridModel::beginUpdate()
+{
+    ++batchDepth;
+}
+
+void SudokuGridModel::endUpdate()
+{
+    if (batchDepth == 0 || --batchDepth > 0)
+        return;
+
+    if (pending.isEmpty())
+        return;
+
+    // Un solo segnale per tutto il blocco di modifiche
+    const QVector<int> changed = std::move(pending);
+    pending.clear();
+    for (int index : changed)
+        pendingMark[index] = false;
+
+    emit cellsChanged(changed);
+}
+
+void SudokuGridModel::touch(int index)
+{
+    if (batchDepth == 0) {
+        emit cellsChanged({index});
+        return;
+    }
+
+    if (!pendingMark[index]) {
+        pendingMark[index] = true;
+        pending.append(index);
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef SUDOKUGRIDMODEL_H
+#define SUDOKUGRIDMODEL_H
+
+#include <QObject>
+#include <QVector>
+
+/**
+ * @brief Values and display state of the Sudoku board, one entry per cell.
+ *
+ * The model is the only thing the grid view paints from. Every change is
+ * reported through `cellsChanged` with the row-major indices of the cells
+ * involved, so the view repaints just those cells. Changes made between
+ * `beginUpdate()` and `endUpdate()` are collected and reported once, so a
+ * mass update (a solved grid, a reset) costs a single repaint.
+ */
+class SudokuGridModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** Display flags of a cell, combined as a bitmask. */
+    enum CellFlag : quint8 {
+        NoFlag = 0x0,
+        /** Locked clue: read-only, drawn on a grey background. */
+        Given  = 0x1,
+        /** Value written by the solver. */
+        Solved = 0x2,
+        /** Entry marked wrong by the check. */
+        Wrong  = 0x4
+    };
+
+    /**
+     * @brief Creates an empty board.
+     * @param dimension Grid size (e.g., 9 for 9x9), a perfect square.
+     * @param parent Optional parent object.
+     */
+    explicit SudokuGridModel(unsigned short dimension, QObject *parent = nullptr);
+
+    /** @brief Grid size (e.g., 9 for 9x9). */
+    [[nodiscard]] unsigned short dimension() const { return dim; }
+    /** @brief Side of a block, `sqrt(dimension)`. */
+    [[nodiscard]] unsigned short blockSize() const { return block; }
+
+    /** @brief Value of a cell, 0 if empty. */
+    [[nodiscard]] unsigned short value(unsigned short row, unsigned short col) const;
+    /** @brief Flags of a cell (CellFlag bitmask). */
+    [[nodiscard]] quint8 flags(unsigned short row, unsigned short col) const;
+    /** @brief true if the cell has the given flag set. */
+    [[nodiscard]] bool hasFlag(unsigned short row, unsigned short col, CellFlag flag) const;
+
+    /**
+     * @brief Sets value and flags of a cell; reported only if something changed.
+     */
+    void setCell(unsigned short row, unsigned short col, unsigned short value, quint8 flags);
+    /** @brief Sets the value of a cell, keeping its flags. */
+    void setValue(unsigned short row, unsigned short col, unsigned short value);
+    /** @brief Sets or clears one flag of a cell. */
+    void setFlag(unsigned short row, unsigned short col, CellFlag flag, bool on = true);
+    /** @brief Clears one flag on every cell. */
+    void clearFlag(CellFlag flag);
+    /** @brief Empties every cell and clears all flags. */
+    void clear();
+
+    /**
+     * @brief Starts collecting changes instead of reporting them one by one.
+     *
+     * Calls can be nested; changes are reported by the outermost `endUpdate()`.
+     */
+    void beginUpdate();
+    /** @brief Reports the changes collected since `beginUpdate()` in one signal. */
+    void endUpdate();
+
+signals:
+    /**
+     * @brief Emitted after cells changed.
+     * @param cells Row-major indices of the changed cells, without duplicates.
+     */
+    void cellsChanged(const QVector<int> &cells);
+
+private:
+    /** @brief Records a changed cell, reporting it now unless a batch is open. */
+    void touch(int index);
+
+    /** Grid size. */
+    unsigned short dim;
+    /** Block side. */
+    unsigned short block;
+    /** Cell values, row-major; 0 for empty cells. */
+    QVector<unsigned short> values;
+    /** Cell flags, row-major. */
+    QVector<quint8> cellFlags;
+
+    /** Nesting depth of `beginUpdate()`. */
+    int batchDepth = 0;
+    /** Cells changed in the current batch. */
+    QVector<int> pending;
+    /** Marks the cells already in `pending`. */
+    QVector<bool> pendingMark;
+};
+
+#endif // SUDOKUGRIDMODEL_H
@@ -0,0 +1,273 @@
+#include "SudokuGridView.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QKeyEvent>
+#include <QMouseEvent>
+
+#include "libs/SudokuSolverAlgorithm.h"
+
+namespace {
+    // Colori della griglia (gli stessi dei vecchi fogli di stile)
+    const QColor cellBackground(Qt::white);
+    const QColor givenBackground(0xee, 0xee, 0xee);
+    const QColor selectedBackground(0xe3, 0xf2, 0xfd);
+    const QColor selectedBorder(0x00, 0x78, 0xd4);
+    const QColor thinLine(0xc0, 0xc0, 0xc0);
+    const QColor entryText(0x33, 0x33, 0x33);
+    const QColor givenText(Qt::black);
+    const QColor solvedText(0x08, 0x8f, 0x8b);
+    const QColor wrongText(0xd3, 0x2f, 0x2f);
+}
+
+SudokuGridView::SudokuGridView(SudokuGridModel *m, QWidget *parent)
+    : QWidget(parent)
+    , model(m)
+{
+    setFocusPolicy(Qt::StrongFocus);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    // Almeno 16 px per cella, perché i simboli restino leggibili anche su 36x36
+    const int side = qMax(30 * 9, 16 * model->dimension());
+    setMinimumSize(side, side);
+
+    // Disegniamo tutto noi: niente sfondo automatico prima di ogni paint
+    setAttribute(Qt::WA_OpaquePaintEvent);
+
+    connect(model, &SudokuGridModel::cellsChanged, this, &SudokuGridView::onCellsChanged);
+}
+
+void SudokuGridView::setSelectedCell(int row, int col)
+{
+    if (row < 0 || col < 0 || row >= model->dimension() || col >= model->dimension())
+        row = col = -1;
+
+    if (selRow >= 0)
+        update(cellRect(selRow, selCol));
+
+    selRow = row;
+    selCol = col;
+
+    if (selRow >= 0) {
+        update(cellRect(selRow, selCol));
+        setFocus();
+    }
+}
+
+void SudokuGridView::setReadOnly(bool ro)
+{
+    readOnly = ro;
+}
+
+QString SudokuGridView::symbolFor(unsigned short value)
+{
+    if (value == 0)
+        return QString();
+    return QString(QChar(SudokuSolverAlgorithm::symbolFor(value)));
+}
+
+unsigned short SudokuGridView::valueFor(QChar symbol, unsigned short dimension)
+{
+    // Lo stesso alfabeto della libreria, così i file e la tastiera coincidono
+    const char latin = symbol.toLatin1();
+    return latin ? SudokuSolverAlgorithm::valueFor(latin, dimension) : 0;
+}
+
+// === Eventi ===
+void SudokuGridView::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    const QRect dirty = event->rect();
+
+    painter.fillRect(dirty, palette().window());
+    if (cellSize <= 0)
+        return;
+
+    const int dim = model->dimension();
+    const int block = model->blockSize();
+
+    painter.setFont(cellFont);
+    painter.fillRect(dirty.intersected(board), cellBackground);
+
+    // Solo le celle toccate dall'area da ridisegnare
+    const int firstRow = qMax(0, (dirty.top() - board.top()) / cellSize);
+    const int lastRow = qMin(dim - 1, (dirty.bottom() - board.top()) / cellSize);
+    const int firstCol = qMax(0, (dirty.left() - board.left()) / cellSize);
+    const int lastCol = qMin(dim - 1, (dirty.right() - board.left()) / cellSize);
+
+    for (int r = firstRow; r <= lastRow; ++r) {
+        for (int c = firstCol; c <= lastCol; ++c) {
+            const QRect rect = cellRect(r, c);
+            const quint8 flags = model->flags(r, c);
+            const bool selected = r == selRow && c == selCol;
+
+            // Lo sfondo bianco è già steso: si ridipingono solo le celle colorate
+            if (selected)
+                painter.fillRect(rect, selectedBackground);
+            else if (flags & SudokuGridModel::Given)
+                painter.fillRect(rect, givenBackground);
+
+            const unsigned short value = model->value(r, c);
+            if (value && value < glyphs.size()) {
+                QColor text = entryText;
+                if (flags & SudokuGridModel::Solved) text = solvedText;
+                if (flags & SudokuGridModel::Given) text = givenText;
+                if (flags & SudokuGridModel::Wrong) text = wrongText;
+                painter.setPen(text);
+
+                const QStaticText &glyph = glyphs[value];
+                const QSizeF size = glyph.size();
+                painter.drawStaticText(QPointF(rect.left() + (rect.width() - size.width()) / 2,
+                                               rect.top() + (rect.height() - size.height()) / 2), glyph);
+            }
+
+        }
+    }
+
+    // Linee sottili: una per riga e colonna invece di un rettangolo per cella
+    painter.setPen(thinLine);
+    for (int k = qMax(1, firstRow); k <= lastRow + 1 && k < dim; ++k) {
+        const int y = board.top() + k * cellSize;
+        painter.drawLine(board.left(), y, board.right(), y);
+    }
+    for (int k = qMax(1, firstCol); k <= lastCol + 1 && k < dim; ++k) {
+        const int x = board.left() + k * cellSize;
+        painter.drawLine(x, board.top(), x, board.bottom());
+    }
+
+    if (selRow >= firstRow && selRow <= lastRow && selCol >= firstCol && selCol <= lastCol) {
+        painter.setPen(QPen(selectedBorder, 2));
+        painter.drawRect(cellRect(selRow, selCol).adjusted(1, 1, -1, -1));
+    }
+
+    // Linee spesse dei blocchi, sopra le celle
+    painter.setPen(QPen(Qt::black, 2));
+    for (int k = 0; k <= dim; k += block) {
+        const int x = board.left() + k * cellSize;
+        const int y = board.top() + k * cellSize;
+        painter.drawLine(x, board.top(), x, board.bottom());
+        painter.drawLine(board.left(), y, board.right(), y);
+    }
+}
+
+void SudokuGridView::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    updateLayout();
+}
+
+void SudokuGridView::keyPressEvent(QKeyEvent *event)
+{
+    switch (event->key()) {
+    case Qt::Key_Left:  moveSelection(0, -1); return;
+    case Qt::Key_Right: moveSelection(0, 1);  return;
+    case Qt::Key_Up:    moveSelection(-1, 0); return;
+    case Qt::Key_Down:  moveSelection(1, 0);  return;
+
+    case Qt::Key_Escape:
+        setSelectedCell(-1, -1);
+        clearFocus();
+        return;
+
+    case Qt::Key_F1:
+        emit solveRequested();
+        return;
+
+    case Qt::Key_Backspace:
+    case Qt::Key_Delete:
+    case Qt::Key_Space:
+        editSelected(0);
+        return;
+
+    default:
+        break;
+    }
+
+    const QString text = event->text();
+    if (text.size() == 1) {
+        const unsigned short value = valueFor(text.at(0), model->dimension());
+        if (value) {
+            editSelected(value);
+            return;
+        }
+    }
+
+    QWidget::keyPressEvent(event);
+}
+
+void SudokuGridView::mousePressEvent(QMouseEvent *event)
+{
+    const QPoint pos = event->position().toPoint();
+    if (cellSize <= 0 || !board.contains(pos)) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+
+    setSelectedCell((pos.y() - board.top()) / cellSize, (pos.x() - board.left()) / cellSize);
+}
+
+void SudokuGridView::onCellsChanged(const QVector<int> &cells)
+{
+    const int dim = model->dimension();
+
+    // Molte celle: un solo update dell'intera griglia costa meno di una regione frammentata
+    if (cells.size() > dim * dim / 4) {
+        update(board);
+        return;
+    }
+
+    for (int index : cells)
+        update(cellRect(index / dim, index % dim));
+}
+
+// === Helper ===
+QRect SudokuGridView::cellRect(int row, int col) const
+{
+    return QRect(board.left() + col * cellSize, board.top() + row * cellSize, cellSize, cellSize);
+}
+
+void SudokuGridView::updateLayout()
+{
+    const int dim = model->dimension();
+    const int side = qMin(width(), height());
+
+    cellSize = dim ? side / dim : 0;
+    const int boardSide = cellSize * dim;
+    board = QRect((width() - boardSide) / 2, (height() - boardSide) / 2, boardSide, boardSide);
+
+    // Il testo occupa circa metà della cella, come il vecchio font Arial 22 su 9x9
+    cellFont = QFont("Arial");
+    cellFont.setBold(true);
+    cellFont.setPixelSize(qMax(6, cellSize * 11 / 20));
+
+    glyphs.resize(dim + 1);
+    for (int v = 1; v <= dim; ++v) {
+        glyphs[v] = QStaticText(symbolFor(v));
+        glyphs[v].setTextFormat(Qt::PlainText);
+        glyphs[v].prepare(QTransform(), cellFont);
+    }
+
+    update();
+}
+
+void SudokuGridView::moveSelection(int dRow, int dCol)
+{
+    if (selRow < 0) {
+        setSelectedCell(0, 0);
+        return;
+    }
+
+    const int dim = model->dimension();
+    setSelectedCell(qBound(0, selRow + dRow, dim - 1), qBound(0, selCol + dCol, dim - 1));
+}
+
+void SudokuGridView::editSelected(unsigned short value)
+{
+    if (readOnly || selRow < 0)
+        return;
+
+    // gli indizi bloccati non si modificano
+    if (model->hasFlag(selRow, selCol, SudokuGridModel::Given))
+        return;
+
+    emit cellEdited(selRow, selCol, value);
+}
@@ -0,0 +1,111 @@
+#ifndef SUDOKUGRIDVIEW_H
+#define SUDOKUGRIDVIEW_H
+
+#include <QWidget>
+#include <QVector>
+#include <QStaticText>
+
+#include "SudokuGridModel.h"
+
+/**
+ * @brief Custom-painted Sudoku board showing a SudokuGridModel.
+ *
+ * The whole board is a single widget: cells are drawn in one paint pass and
+ * only the cells reported by the model are repainted. The view also handles
+ * selection and keyboard editing itself; edits are not applied directly but
+ * emitted through `cellEdited`, so the window can validate them first.
+ *
+ * The board stays square and centred in the widget. Glyphs for the cell
+ * symbols are laid out once per size (QStaticText) and reused by every paint,
+ * and the thin lines are drawn once per row and column, so even a 36x36 board
+ * (1296 cells) repaints in a single cheap pass.
+ */
+class SudokuGridView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Creates the view for a model (not owned).
+     * @param model Board to show.
+     * @param parent Optional parent widget.
+     */
+    explicit SudokuGridView(SudokuGridModel *model, QWidget *parent = nullptr);
+
+    /** @brief true if a cell is selected. */
+    [[nodiscard]] bool hasSelection() const { return selRow >= 0; }
+    /** @brief Row of the selected cell, -1 if none. */
+    [[nodiscard]] int selectedRow() const { return selRow; }
+    /** @brief Column of the selected cell, -1 if none. */
+    [[nodiscard]] int selectedColumn() const { return selCol; }
+    /**
+     * @brief Selects a cell and gives the view the keyboard focus.
+     * @param row Zero-based row, or -1 to clear the selection.
+     * @param col Zero-based column, or -1 to clear the selection.
+     */
+    void setSelectedCell(int row, int col);
+
+    /** @brief Blocks (or allows) every edit, e.g. while solving. */
+    void setReadOnly(bool readOnly);
+    /** @brief true if edits are blocked. */
+    [[nodiscard]] bool isReadOnly() const { return readOnly; }
+
+    /**
+     * @brief Symbol shown for a value: 1-9, then A-Z, then 0 for 36.
+     * @param value Value in [1, 36].
+     */
+    static QString symbolFor(unsigned short value);
+    /**
+     * @brief Value typed with a symbol, case-insensitive.
+     * @param symbol Character typed by the user.
+     * @param dimension Grid size; symbols above it are rejected.
+     * @return The value in [1, dimension], or 0 if the symbol is not valid.
+     */
+    static unsigned short valueFor(QChar symbol, unsigned short dimension);
+
+signals:
+    /**
+     * @brief The user typed a value (or cleared a cell, with value 0).
+     */
+    void cellEdited(unsigned short row, unsigned short col, unsigned short value);
+    /** @brief The user pressed F1. */
+    void solveRequested();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private slots:
+    /** @brief Schedules a repaint of the changed cells only. */
+    void onCellsChanged(const QVector<int> &cells);
+
+private:
+    /** @brief Rectangle of a cell in widget coordinates. */
+    [[nodiscard]] QRect cellRect(int row, int col) const;
+    /** @brief Recomputes board geometry, font and glyph cache for the current size. */
+    void updateLayout();
+    /** @brief Moves the selection by an offset, staying inside the board. */
+    void moveSelection(int dRow, int dCol);
+    /** @brief Emits `cellEdited` for the selected cell if it can be edited. */
+    void editSelected(unsigned short value);
+
+    /** Board shown (not owned). */
+    SudokuGridModel *model;
+    /** Board area, square and centred. */
+    QRect board;
+    /** Side of a cell, in pixels. */
+    int cellSize = 0;
+    /** Selected cell, -1 if none. */
+    int selRow = -1;
+    int selCol = -1;
+    /** Blocks every edit. */
+    bool readOnly = false;
+    /** Font of the cell symbols, scaled with the cells. */
+    QFont cellFont;
+    /** Laid-out symbol of each value (index = value). */
+    QVector<QStaticText> glyphs;
+};
+
+#endif // SUDOKUGRIDVIEW_H
@@ -0,0 +1,165 @@
+#include "CheckpointWriter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+CheckpointWriter::CheckpointWriter(std::string path)
+    : target(std::move(path))
+    , thread([this] { run(); }) {
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        quit = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void CheckpointWriter::submit(std::vector<uint8_t> &data) {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        // Il checkpoint non ancora scritto è superato da questo: si scambiano i buffer
+        pending.swap(data);
+        hasPending = true;
+    }
+    data.clear();
+    wake.notify_one();
+}
+
+void CheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    written.wait(lock, [this] { return !hasPending && !writing; });
+}
+
+void CheckpointWriter::run() {
+    std::vector<uint8_t> data;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return hasPending || quit; });
+        // All'uscita si scrive comunque l'ultimo checkpoint in attesa
+        if (!hasPending)
+            return;
+
+        data.swap(pending);
+        hasPending = false;
+        writing = true;
+        lock.unlock();
+
+        std::error_code error;
+        writeAtomically(target, data, error);
+
+        lock.lock();
+        lastError = error;
+        writing = false;
+        written.notify_all();
+    }
+}
+
+std::error_code CheckpointWriter::error() {
+    std::lock_guard<std::mutex> guard(mutex);
+    return lastError;
+}
+
+bool CheckpointWriter::writeAtomically(const std::string &path, std::span<const uint8_t> data) {
+    std::error_code error;
+    return writeAtomically(path, data, error);
+}
+
+/*
+ * Il file temporaneo va su disco prima della rinomina, e la rinomina prima di dichiarare il
+ * checkpoint scritto: dopo un'interruzione di corrente il file è il vecchio o il nuovo, mai vuoto.
+ */
+bool CheckpointWriter::writeAtomically(const std::string &path, std::span<const uint8_t> data, std::error_code &error) {
+    const std::filesystem::path target(path);
+    std::filesystem::path temporary(target);
+    temporary += ".tmp";
+
+#ifdef _WIN32
+    auto fail = [&error] {
+        error.assign(static_cast<int>(GetLastError()), std::system_category());
+        return false;
+    };
+    const HANDLE file = CreateFileW(temporary.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return fail();
+    size_t at = 0;
+    bool ok = true;
+    while (ok && at < data.size()) {
+        DWORD done = 0;
+        const auto chunk = static_cast<DWORD>(std::min<size_t>(data.size() - at, 1u << 30));
+        ok = WriteFile(file, data.data() + at, chunk, &done, nullptr) != 0;
+        at += done;
+    }
+    ok = ok && FlushFileBuffers(file) != 0;
+    if (!ok) {
+        fail();
+        CloseHandle(file);
+        DeleteFileW(temporary.c_str());
+        return false;
+    }
+    CloseHandle(file);
+
+    // Con WRITE_THROUGH la sostituzione è su disco quando la chiamata ritorna
+    if (!MoveFileExW(temporary.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+        return fail();
+#else
+    auto fail = [&error] {
+        error.assign(errno, std::generic_category());
+        return false;
+    };
+    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return fail();
+    size_t at = 0;
+    bool ok = true;
+    while (ok && at < data.size()) {
+        const ssize_t done = ::write(fd, data.data() + at, data.size() - at);
+        if (done < 0 && errno == EINTR)
+            continue;
+        ok = done > 0;
+        at += ok ? static_cast<size_t>(done) : 0;
+    }
+    ok = ok && ::fsync(fd) == 0;
+    if (!ok) {
+        fail();
+        ::close(fd);
+        ::unlink(temporary.c_str());
+        return false;
+    }
+    if (::close(fd) != 0 || ::rename(temporary.c_str(), target.c_str()) != 0)
+        return fail();
+
+    // La rinomina è durevole solo quando lo è la directory che contiene il file
+    const std::filesystem::path parent = target.has_parent_path() ? target.parent_path() : std::filesystem::path(".");
+    const int directory = ::open(parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directory < 0)
+        return fail();
+    ok = ::fsync(directory) == 0;
+    if (!ok)
+        fail();
+    ::close(directory);
+    if (!ok)
+        return false;
+#endif
+    error.clear();
+    return true;
+}
+
+bool CheckpointWriter::read(const std::string &path, std::vector<uint8_t> &out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return !in.bad();
+}
@@ -0,0 +1,83 @@
+#ifndef CHECKPOINTWRITER_LIBRARY_H
+#define CHECKPOINTWRITER_LIBRARY_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+/**
+ * @file CheckpointWriter.h
+ * @brief Writes search checkpoints to a file on a thread of its own.
+ *
+ * The search only serializes its state into a buffer and hands it over with
+ * `submit()`; the file is written by the writer thread, so a slow disk never
+ * holds up the search. If a checkpoint arrives while the previous one is still
+ * being written, only the newest is kept.
+ *
+ * Every write goes to `<path>.tmp` first, is flushed to the disk, and then
+ * replaces the file with a rename that is flushed too, so the file always
+ * holds a complete checkpoint, even after a crash or a power loss in the
+ * middle of a write.
+ */
+class CheckpointWriter {
+public:
+    /** @brief Starts the writer thread for a checkpoint file. */
+    explicit CheckpointWriter(std::string path);
+    /** @brief Writes the pending checkpoint, if any, and joins the thread. */
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    /**
+     * @brief Queues a checkpoint for writing.
+     * @param data Serialized state; swapped with a spare buffer, so the caller
+     *        gets back capacity to reuse and steady checkpointing does not allocate.
+     */
+    void submit(std::vector<uint8_t> &data);
+    /** @brief Waits until every submitted checkpoint is on disk. */
+    void flush();
+
+    /** @brief The checkpoint file. */
+    [[nodiscard]] const std::string &path() const { return target; }
+    /** @brief Error of the last write; empty if it succeeded or nothing was written yet. */
+    [[nodiscard]] std::error_code error();
+
+    /**
+     * @brief Replaces a file with new contents through a temporary file and a rename.
+     *
+     * The data and the rename are on disk when the call returns.
+     * @return false if the data could not be written.
+     */
+    static bool writeAtomically(const std::string &path, std::span<const uint8_t> data);
+    /** @brief As above; `error` receives the reason of a failure, and is cleared on success. */
+    static bool writeAtomically(const std::string &path, std::span<const uint8_t> data, std::error_code &error);
+    /**
+     * @brief Reads a whole file.
+     * @return false if the file cannot be read.
+     */
+    static bool read(const std::string &path, std::vector<uint8_t> &out);
+
+private:
+    /** @brief Writer thread: waits for checkpoints and writes them. */
+    void run();
+
+    std::string target;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable written;
+    /** Newest checkpoint not written yet. */
+    std::vector<uint8_t> pending;
+    bool hasPending = false;
+    bool writing = false;
+    std::error_code lastError;
+    bool quit = false;
+    std::thread thread;
+};
+
+#endif // CHECKPOINTWRITER_LIBRARY_H
@@ -0,0 +1,113 @@
+#ifndef DEADSTATETABLE_LIBRARY_H
+#define DEADSTATETABLE_LIBRARY_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @file DeadStateTable.h
+ * @brief Fixed-size transposition table of partial grids proven to have no solution.
+ *
+ * Entries are 64-bit Zobrist keys of a set of placed values (the XOR of one
+ * random key per cell and value). Whether a partial grid can be completed
+ * depends only on its values, not on which of them are clues, so an entry
+ * stays true across searches and puzzle edits at the same dimension.
+ *
+ * The table is an array of four-entry buckets (one cache line each) whose
+ * size is fixed by the memory budget. When a bucket is full, the new entry
+ * replaces the one that saves the least work: entries from older searches
+ * go first, then those with the fewest empty cells (the smallest subtrees).
+ */
+class DeadStateTable {
+public:
+    /**
+     * @brief Sets the memory budget and empties the table.
+     * @param bytes At most this much memory is used (rounded down to a power
+     *        of two of buckets); 0 disables the table.
+     */
+    void setBudget(size_t bytes) {
+        size_t count = bytes / sizeof(Bucket);
+        count = count ? std::bit_floor(count) : 0;
+        buckets.reset(count ? new Bucket[count] : nullptr);
+        mask = count ? count - 1 : 0;
+        capacity = count;
+        clear();
+    }
+
+    /** @brief true if the table has a budget. */
+    [[nodiscard]] bool enabled() const { return capacity > 0; }
+
+    /** @brief Bytes used by the table. */
+    [[nodiscard]] size_t bytes() const { return capacity * sizeof(Bucket); }
+
+    /** @brief Forgets every entry, keeping the memory. */
+    void clear() {
+        std::fill_n(buckets.get(), capacity, Bucket{});
+        generation = 1;
+    }
+
+    /** @brief Starts a new search: entries from earlier ones become the first to be replaced. */
+    void nextGeneration() {
+        generation = static_cast<uint16_t>(generation == UINT16_MAX ? 1 : generation + 1);
+    }
+
+    /** @brief true if the state with this key is known to be dead. */
+    [[nodiscard]] bool contains(uint64_t key) const {
+        key = nonZero(key);
+        const Bucket &bucket = buckets[key & mask];
+        for (const Entry &entry : bucket.entries)
+            if (entry.key == key)
+                return true;
+        return false;
+    }
+
+    /**
+     * @brief Records a dead state.
+     * @param emptyCells Empty cells of the state: how large a subtree the entry cuts.
+     */
+    void insert(uint64_t key, unsigned int emptyCells) {
+        key = nonZero(key);
+        Bucket &bucket = buckets[key & mask];
+        const auto empty = static_cast<uint16_t>(std::min(emptyCells, 0x7FFFu));
+
+        Entry *victim = &bucket.entries[0];
+        uint32_t victimWorth = UINT32_MAX;
+        for (Entry &entry : bucket.entries) {
+            if (entry.key == key) {
+                entry.generation = generation;
+                return;
+            }
+            // Empty entries are worth nothing, entries of earlier searches less than current ones
+            const uint32_t worth = entry.key == 0 ? 0
+                                 : entry.empty + (entry.generation == generation ? 0x8000u : 0u);
+            if (worth < victimWorth) {
+                victim = &entry;
+                victimWorth = worth;
+            }
+        }
+        *victim = {key, empty, generation};
+    }
+
+private:
+    struct Entry {
+        uint64_t key = 0;
+        uint16_t empty = 0;
+        uint16_t generation = 0;
+    };
+    struct alignas(64) Bucket {
+        Entry entries[4];
+    };
+
+    /** 0 marks an empty entry, so it is never used as a key. */
+    static uint64_t nonZero(uint64_t key) { return key ? key : 1; }
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t capacity = 0;
+    size_t mask = 0;
+    uint16_t generation = 1;
+};
+
+#endif // DEADSTATETABLE_LIBRARY_H
@@ -0,0 +1,465 @@
+#include "SatSolver.h"
+
+#include <algorithm>
+
+int SatSolver::newVar() {
+    const int var = varCount();
+    assigns.push_back(Undef);
+    polarity.push_back(False);
+    level.push_back(0);
+    reason.push_back(noReason);
+    activity.push_back(0);
+    seen.push_back(0);
+    heapIndex.push_back(-1);
+    watches.emplace_back();
+    watches.emplace_back();
+    heapInsert(var);
+    return var;
+}
+
+void SatSolver::setPolarity(int var, bool value) {
+    polarity[var] = value ? True : False;
+}
+
+bool SatSolver::addClause(std::span<const Lit> literals) {
+    if (unsatisfiable)
+        return false;
+    backtrack(0);
+
+    // Al livello 0: letterali falsi tolti, duplicati uniti, clausole già vere scartate
+    std::vector<Lit> clause(literals.begin(), literals.end());
+    std::sort(clause.begin(), clause.end());
+    size_t kept = 0;
+    for (size_t i = 0; i < clause.size(); ++i) {
+        const Lit lit = clause[i];
+        if (litValue(lit) == True || (kept > 0 && clause[kept - 1] == (lit ^ 1)))
+            return true;
+        if (litValue(lit) == False || (kept > 0 && clause[kept - 1] == lit))
+            continue;
+        clause[kept++] = lit;
+    }
+    clause.resize(kept);
+
+    if (clause.empty()) {
+        unsatisfiable = true;
+        return false;
+    }
+    if (clause.size() == 1) {
+        enqueue(clause[0], noReason);
+        if (propagate() != noReason)
+            unsatisfiable = true;
+        return !unsatisfiable;
+    }
+    attachClause(clause, false);
+    return true;
+}
+
+uint32_t SatSolver::attachClause(std::span<const Lit> literals, bool learnt) {
+    const auto index = static_cast<uint32_t>(clauses.size());
+    Clause clause;
+    clause.start = static_cast<uint32_t>(literalPool.size());
+    clause.size = static_cast<uint32_t>(literals.size());
+    clause.learnt = learnt;
+    literalPool.insert(literalPool.end(), literals.begin(), literals.end());
+    clauses.push_back(clause);
+
+    watches[literals[0]].push_back({index, literals[1]});
+    watches[literals[1]].push_back({index, literals[0]});
+    if (learnt)
+        learntClauses.push_back(index);
+    return index;
+}
+
+void SatSolver::enqueue(Lit lit, int why) {
+    const int var = lit >> 1;
+    assigns[var] = (lit & 1) ? False : True;
+    level[var] = decisionLevel();
+    reason[var] = why;
+    trail.push_back(lit);
+}
+
+int SatSolver::propagate() {
+    while (propagateHead < trail.size()) {
+        const Lit falseLit = trail[propagateHead++] ^ 1;
+        std::vector<Watch> &list = watches[falseLit];
+        ++stats.propagations;
+
+        size_t i = 0;
+        size_t j = 0;
+        while (i < list.size()) {
+            const Watch watch = list[i];
+            // Il letterale di guardia è vero: la clausola è soddisfatta, non serve aprirla
+            if (litValue(watch.blocker) == True) {
+                list[j++] = list[i++];
+                continue;
+            }
+            const Clause &clause = clauses[watch.clause];
+            if (clause.deleted) {
+                ++i;
+                continue;
+            }
+
+            Lit *lits = &literalPool[clause.start];
+            if (lits[0] == falseLit)
+                std::swap(lits[0], lits[1]);
+            ++i;
+
+            const Lit first = lits[0];
+            const Watch updated{watch.clause, first};
+            if (first != watch.blocker && litValue(first) == True) {
+                list[j++] = updated;
+                continue;
+            }
+
+            // Si cerca un altro letterale non falso da guardare al posto di falseLit
+            bool moved = false;
+            for (uint32_t k = 2; k < clause.size; ++k) {
+                if (litValue(lits[k]) != False) {
+                    lits[1] = lits[k];
+                    lits[k] = falseLit;
+                    watches[lits[1]].push_back(updated);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved)
+                continue;
+
+            // Clausola unitaria o in conflitto
+            list[j++] = updated;
+            if (litValue(first) == False) {
+                while (i < list.size())
+                    list[j++] = list[i++];
+                list.resize(j);
+                propagateHead = trail.size();
+                return static_cast<int>(watch.clause);
+            }
+            enqueue(first, static_cast<int>(watch.clause));
+        }
+        list.resize(j);
+    }
+    return noReason;
+}
+
+int SatSolver::analyze(int conflict, std::vector<Lit> &learnt) {
+    learnt.clear();
+    learnt.push_back(0); // posto per il letterale UIP
+
+    int pending = 0;
+    Lit uip = -1;
+    size_t index = trail.size();
+    do {
+        Clause &clause = clauses[conflict];
+        if (clause.learnt)
+            bumpClause(clause);
+
+        const Lit *lits = &literalPool[clause.start];
+        // Nelle clausole ragione il primo letterale è quello implicato
+        for (uint32_t k = (uip == -1 ? 0 : 1); k < clause.size; ++k) {
+            const int var = lits[k] >> 1;
+            if (seen[var] || level[var] == 0)
+                continue;
+            bumpVar(var);
+            seen[var] = 1;
+            if (level[var] >= decisionLevel())
+                ++pending;
+            else
+                learnt.push_back(lits[k]);
+        }
+
+        while (!seen[trail[--index] >> 1]) {
+        }
+        uip = trail[index];
+        conflict = reason[uip >> 1];
+        seen[uip >> 1] = 0;
+        --pending;
+    } while (pending > 0);
+    learnt[0] = uip ^ 1;
+
+    // Minimizzazione locale: un letterale implicato solo da altri letterali della
+    // clausola è ridondante
+    analyzeStack.assign(learnt.begin(), learnt.end());
+    size_t kept = 1;
+    for (size_t i = 1; i < learnt.size(); ++i) {
+        const int var = learnt[i] >> 1;
+        const int why = reason[var];
+        bool redundant = why != noReason;
+        if (redundant) {
+            const Clause &clause = clauses[why];
+            const Lit *lits = &literalPool[clause.start];
+            for (uint32_t k = 1; k < clause.size; ++k) {
+                const int other = lits[k] >> 1;
+                if (!seen[other] && level[other] > 0) {
+                    redundant = false;
+                    break;
+                }
+            }
+        }
+        if (!redundant)
+            learnt[kept++] = learnt[i];
+    }
+    learnt.resize(kept);
+    for (const Lit lit : analyzeStack)
+        seen[lit >> 1] = 0;
+
+    // Si torna al livello più alto tra gli altri letterali, che va in seconda posizione
+    int backLevel = 0;
+    if (learnt.size() > 1) {
+        size_t highest = 1;
+        for (size_t i = 2; i < learnt.size(); ++i)
+            if (level[learnt[i] >> 1] > level[learnt[highest] >> 1])
+                highest = i;
+        std::swap(learnt[1], learnt[highest]);
+        backLevel = level[learnt[1] >> 1];
+    }
+    return backLevel;
+}
+
+void SatSolver::backtrack(int target) {
+    if (decisionLevel() <= target)
+        return;
+    for (size_t i = trail.size(); i-- > trailLimits[target];) {
+        const int var = trail[i] >> 1;
+        // Phase saving: la variabile riprenderà il valore che aveva
+        polarity[var] = assigns[var];
+        assigns[var] = Undef;
+        reason[var] = noReason;
+        heapInsert(var);
+    }
+    trail.resize(trailLimits[target]);
+    trailLimits.resize(target);
+    propagateHead = trail.size();
+}
+
+int SatSolver::pickBranchVar() {
+    while (!heap.empty()) {
+        const int var = heapPop();
+        if (assigns[var] == Undef)
+            return var;
+    }
+    return -1;
+}
+
+void SatSolver::reduceLearnts() {
+    // Le clausole che sono ragione di un assegnamento corrente non si possono togliere
+    auto locked = [this](uint32_t index) {
+        const Lit first = literalPool[clauses[index].start];
+        return litValue(first) == True && reason[first >> 1] == static_cast<int>(index);
+    };
+
+    std::sort(learntClauses.begin(), learntClauses.end(), [this](uint32_t a, uint32_t b) {
+        const Clause &x = clauses[a];
+        const Clause &y = clauses[b];
+        if (x.lbd != y.lbd)
+            return x.lbd > y.lbd;
+        return x.activity < y.activity;
+    });
+
+    const size_t half = learntClauses.size() / 2;
+    size_t kept = 0;
+    for (size_t i = 0; i < learntClauses.size(); ++i) {
+        const uint32_t index = learntClauses[i];
+        Clause &clause = clauses[index];
+        // Le clausole "glue" (LBD <= 2) e le binarie restano sempre
+        if (i < half && clause.lbd > 2 && clause.size > 2 && !locked(index)) {
+            clause.deleted = true;
+            wastedLiterals += clause.size;
+            ++stats.deleted;
+        } else {
+            learntClauses[kept++] = index;
+        }
+    }
+    learntClauses.resize(kept);
+
+    // I watch delle clausole tolte spariscono subito, i letterali restano nel pool
+    for (std::vector<Watch> &list : watches)
+        std::erase_if(list, [this](const Watch &watch) { return clauses[watch.clause].deleted; });
+
+    // Quando metà del pool è di clausole tolte lo si compatta; gli indici delle clausole non cambiano
+    if (wastedLiterals * 2 > literalPool.size()) {
+        size_t end = 0;
+        for (Clause &clause : clauses) {
+            if (clause.deleted) {
+                clause.size = 0;
+                continue;
+            }
+            std::copy_n(literalPool.begin() + clause.start, clause.size, literalPool.begin() + end);
+            clause.start = static_cast<uint32_t>(end);
+            end += clause.size;
+        }
+        literalPool.resize(end);
+        wastedLiterals = 0;
+    }
+}
+
+void SatSolver::bumpVar(int var) {
+    activity[var] += varIncrement;
+    if (activity[var] > 1e100) {
+        for (double &value : activity)
+            value *= 1e-100;
+        varIncrement *= 1e-100;
+    }
+    if (heapIndex[var] >= 0)
+        heapUp(static_cast<size_t>(heapIndex[var]));
+}
+
+void SatSolver::bumpClause(Clause &clause) {
+    clause.activity += clauseIncrement;
+    if (clause.activity > 1e20f) {
+        for (const uint32_t index : learntClauses)
+            clauses[index].activity *= 1e-20f;
+        clauseIncrement *= 1e-20f;
+    }
+}
+
+void SatSolver::heapInsert(int var) {
+    if (heapIndex[var] >= 0)
+        return;
+    heapIndex[var] = static_cast<int>(heap.size());
+    heap.push_back(var);
+    heapUp(heap.size() - 1);
+}
+
+void SatSolver::heapUp(size_t index) {
+    const int var = heap[index];
+    while (index > 0) {
+        const size_t parent = (index - 1) / 2;
+        if (activity[heap[parent]] >= activity[var])
+            break;
+        heap[index] = heap[parent];
+        heapIndex[heap[index]] = static_cast<int>(index);
+        index = parent;
+    }
+    heap[index] = var;
+    heapIndex[var] = static_cast<int>(index);
+}
+
+void SatSolver::heapDown(size_t index) {
+    const int var = heap[index];
+    for (;;) {
+        size_t child = 2 * index + 1;
+        if (child >= heap.size())
+            break;
+        if (child + 1 < heap.size() && activity[heap[child + 1]] > activity[heap[child]])
+            ++child;
+        if (activity[heap[child]] <= activity[var])
+            break;
+        heap[index] = heap[child];
+        heapIndex[heap[index]] = static_cast<int>(index);
+        index = child;
+    }
+    heap[index] = var;
+    heapIndex[var] = static_cast<int>(index);
+}
+
+int SatSolver::heapPop() {
+    const int top = heap.front();
+    heapIndex[top] = -1;
+    const int last = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        heap[0] = last;
+        heapIndex[last] = 0;
+        heapDown(0);
+    }
+    return top;
+}
+
+double SatSolver::luby(double base, int index) {
+    // Si trova la sottosequenza completa che contiene index, poi la posizione al suo interno
+    int size = 1;
+    int sequence = 0;
+    while (size < index + 1) {
+        ++sequence;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != index) {
+        size = (size - 1) >> 1;
+        --sequence;
+        index %= size;
+    }
+    double result = 1;
+    for (int i = 0; i < sequence; ++i)
+        result *= base;
+    return result;
+}
+
+SatSolver::Result SatSolver::solve(const std::atomic<bool> *stop) {
+    if (unsatisfiable)
+        return Result::Unsatisfiable;
+    backtrack(0);
+    if (propagate() != noReason) {
+        unsatisfiable = true;
+        return Result::Unsatisfiable;
+    }
+
+    if (maxLearnts == 0)
+        maxLearnts = std::max<double>(2000, clauses.size() / 3.0);
+
+    std::vector<Lit> learnt;
+    for (int restart = 0;; ++restart) {
+        const auto budget = static_cast<uint64_t>(luby(2, restart) * 100);
+        uint64_t conflicts = 0;
+
+        for (;;) {
+            const int conflict = propagate();
+            if (conflict != noReason) {
+                ++stats.conflicts;
+                ++conflicts;
+                if (decisionLevel() == 0) {
+                    unsatisfiable = true;
+                    return Result::Unsatisfiable;
+                }
+
+                const int backLevel = analyze(conflict, learnt);
+                backtrack(backLevel);
+                if (learnt.size() == 1) {
+                    enqueue(learnt[0], noReason);
+                } else {
+                    const uint32_t index = attachClause(learnt, true);
+                    // LBD: quanti livelli di decisione distinti tocca la clausola
+                    analyzeStack.clear();
+                    for (const Lit lit : learnt)
+                        analyzeStack.push_back(level[lit >> 1]);
+                    std::sort(analyzeStack.begin(), analyzeStack.end());
+                    clauses[index].lbd = static_cast<uint32_t>(
+                        std::unique(analyzeStack.begin(), analyzeStack.end()) - analyzeStack.begin());
+                    bumpClause(clauses[index]);
+                    enqueue(learnt[0], static_cast<int>(index));
+                }
+                ++stats.learnt;
+                varIncrement /= 0.95;
+                clauseIncrement /= 0.999f;
+
+                if (stop && stop->load(std::memory_order_relaxed)) {
+                    backtrack(0);
+                    return Result::Stopped;
+                }
+                continue;
+            }
+
+            if (conflicts >= budget) {
+                ++stats.restarts;
+                backtrack(0);
+                break;
+            }
+            if (static_cast<double>(learntClauses.size()) - trail.size() >= maxLearnts) {
+                reduceLearnts();
+                maxLearnts *= 1.1;
+            }
+
+            const int var = pickBranchVar();
+            if (var < 0) {
+                // Tutte le variabili assegnate senza conflitti: è un modello
+                model.resize(assigns.size());
+                for (size_t v = 0; v < assigns.size(); ++v)
+                    model[v] = assigns[v] == True;
+                backtrack(0);
+                return Result::Satisfiable;
+            }
+            ++stats.decisions;
+            trailLimits.push_back(trail.size());
+            enqueue(polarity[var] == True ? pos(var) : neg(var), noReason);
+        }
+    }
+}
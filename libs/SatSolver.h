@@ -0,0 +1,155 @@
+#ifndef SATSOLVER_LIBRARY_H
+#define SATSOLVER_LIBRARY_H
+
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @file SatSolver.h
+ * @brief Small self-contained CDCL SAT solver, used by the SAT engine of the Sudoku solver.
+ *
+ * A conflict-driven clause-learning core in the MiniSat tradition:
+ * - two watched literals per clause (with a blocker literal), so propagation
+ *   only visits the clauses whose watch became false;
+ * - first-UIP conflict analysis with local minimization of the learnt clause;
+ * - VSIDS variable activity on a binary heap, with phase saving;
+ * - Luby restarts;
+ * - periodic deletion of the less useful learnt clauses (by LBD, then activity).
+ *
+ * Clauses can be added between solves (e.g. to block a model and look for
+ * another one). The solver has no dependencies beyond the standard library.
+ */
+class SatSolver {
+public:
+    /** A literal: `2 * var` for the variable, `2 * var + 1` for its negation. */
+    using Lit = int;
+
+    /** @brief The positive literal of a variable. */
+    static constexpr Lit pos(int var) { return 2 * var; }
+    /** @brief The negative literal of a variable. */
+    static constexpr Lit neg(int var) { return 2 * var + 1; }
+
+    enum class Result { Satisfiable, Unsatisfiable, Stopped };
+
+    /** Counters of the solver, cumulative over every `solve()`. */
+    struct Statistics {
+        uint64_t decisions = 0;
+        uint64_t conflicts = 0;
+        uint64_t propagations = 0;
+        uint64_t restarts = 0;
+        uint64_t learnt = 0;
+        uint64_t deleted = 0;
+    };
+
+    /** @brief Adds a variable, false by default in the first decisions. */
+    int newVar();
+    /** @brief Number of variables. */
+    [[nodiscard]] int varCount() const { return static_cast<int>(assigns.size()); }
+
+    /**
+     * @brief Adds a clause (a disjunction of literals).
+     * @return false if the formula is now known to be unsatisfiable.
+     */
+    bool addClause(std::span<const Lit> literals);
+
+    /** @brief Value a variable should take when the solver first decides on it. */
+    void setPolarity(int var, bool value);
+
+    /**
+     * @brief Looks for a model of the clauses added so far.
+     * @param stop Polled between conflicts; when set, the search returns Stopped.
+     */
+    Result solve(const std::atomic<bool> *stop = nullptr);
+
+    /** @brief Value of a variable in the last model found. */
+    [[nodiscard]] bool modelValue(int var) const { return model[var]; }
+
+    [[nodiscard]] const Statistics &statistics() const { return stats; }
+
+private:
+    /** Truth values; `Undef` for unassigned variables. */
+    enum : int8_t { False = 0, True = 1, Undef = 2 };
+
+    /** A clause as a slice of `literalPool`; the first two literals are watched. */
+    struct Clause {
+        uint32_t start;
+        uint32_t size;
+        uint32_t lbd = 0;
+        float activity = 0;
+        bool learnt = false;
+        bool deleted = false;
+    };
+
+    /** A clause watching a literal, with another of its literals to skip it cheaply. */
+    struct Watch {
+        uint32_t clause;
+        Lit blocker;
+    };
+
+    static constexpr int noReason = -1;
+
+    [[nodiscard]] int8_t litValue(Lit lit) const {
+        const int8_t v = assigns[lit >> 1];
+        return v == Undef ? v : static_cast<int8_t>(v ^ (lit & 1));
+    }
+    [[nodiscard]] int decisionLevel() const { return static_cast<int>(trailLimits.size()); }
+
+    /** @brief Stores a clause of at least two literals and watches its first two. */
+    uint32_t attachClause(std::span<const Lit> literals, bool learnt);
+    void enqueue(Lit lit, int reason);
+    /** @brief Unit propagation; returns the conflicting clause or `noReason`. */
+    int propagate();
+    /** @brief First-UIP learnt clause for a conflict; returns the level to go back to. */
+    int analyze(int conflict, std::vector<Lit> &learnt);
+    void backtrack(int level);
+    /** @brief Unassigned variable with the highest activity, or -1. */
+    int pickBranchVar();
+    /** @brief Drops about half of the learnt clauses, keeping the most useful ones. */
+    void reduceLearnts();
+
+    void bumpVar(int var);
+    void bumpClause(Clause &clause);
+    void heapInsert(int var);
+    void heapUp(size_t index);
+    void heapDown(size_t index);
+    int heapPop();
+
+    /** Luby sequence (1, 1, 2, 1, 1, 2, 4, ...), the restart schedule. */
+    static double luby(double base, int index);
+
+    std::vector<Lit> literalPool;
+    /** Literals of deleted clauses still in `literalPool`. */
+    size_t wastedLiterals = 0;
+    std::vector<Clause> clauses;
+    std::vector<uint32_t> learntClauses;
+    /** Clauses watching each literal, visited when the literal becomes false. */
+    std::vector<std::vector<Watch>> watches;
+
+    std::vector<int8_t> assigns;
+    std::vector<int8_t> polarity;
+    std::vector<int> level;
+    std::vector<int> reason;
+    std::vector<Lit> trail;
+    std::vector<size_t> trailLimits;
+    size_t propagateHead = 0;
+
+    std::vector<double> activity;
+    double varIncrement = 1;
+    float clauseIncrement = 1;
+    /** Max-heap of variables by activity, with the position of each variable. */
+    std::vector<int> heap;
+    std::vector<int> heapIndex;
+
+    /** Scratch of `analyze()`. */
+    std::vector<char> seen;
+    std::vector<Lit> analyzeStack;
+
+    std::vector<bool> model;
+    bool unsatisfiable = false;
+    double maxLearnts = 0;
+    Statistics stats;
+};
+
+#endif // SATSOLVER_LIBRARY_H
@@ -0,0 +1,140 @@
+#include "SearchTrace.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr char magic[4] = {'S', 'D', 'K', 'T'};
+constexpr uint8_t version = 1;
+constexpr size_t blockSize = 256 * 1024;
+/** Blocchi in attesa oltre i quali la ricerca aspetta il disco invece di accumulare memoria */
+constexpr size_t maxQueued = 16;
+constexpr size_t readChunk = 64 * 1024;
+
+/** Campi che seguono il primo varint, per tipo di evento */
+constexpr int fieldCount[8] = {2, 1, 2, 1, 0, 0, 0, 2};
+
+}
+
+SearchTraceWriter::SearchTraceWriter(const std::string &path)
+    : file(path, std::ios::binary | std::ios::trunc)
+    , thread([this] { run(); }) {
+    block.resize(blockSize);
+    cursor = block.data();
+    limit = cursor + block.size();
+    std::copy(magic, magic + sizeof(magic), cursor);
+    cursor += sizeof(magic);
+    *cursor++ = version;
+}
+
+SearchTraceWriter::~SearchTraceWriter() {
+    handOff();
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        quit = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+bool SearchTraceWriter::good() const {
+    std::lock_guard<std::mutex> guard(mutex);
+    return !failed && file.is_open();
+}
+
+void SearchTraceWriter::handOff() {
+    const size_t used = static_cast<size_t>(cursor - block.data());
+    if (used == 0)
+        return;
+    block.resize(used);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    // Il thread di scrittura è indietro di troppi blocchi: meglio rallentare che perdere eventi
+    drained.wait(lock, [this] { return full.size() < maxQueued; });
+    full.push_back(std::move(block));
+    if (!spare.empty()) {
+        block = std::move(spare.back());
+        spare.pop_back();
+    } else {
+        block = {};
+    }
+    lock.unlock();
+    wake.notify_one();
+
+    block.resize(blockSize);
+    cursor = block.data();
+    limit = cursor + block.size();
+}
+
+void SearchTraceWriter::flush() {
+    handOff();
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [this] { return full.empty() && !writing; });
+}
+
+void SearchTraceWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return !full.empty() || quit; });
+        // All'uscita si scrivono comunque i blocchi in attesa
+        if (full.empty())
+            return;
+
+        std::vector<uint8_t> data = std::move(full.front());
+        full.pop_front();
+        writing = true;
+        lock.unlock();
+
+        bool ok = true;
+        if (file.is_open()) {
+            file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+            // Blocco scritto e coda vuota: il file è completo fino a qui
+            ok = file.flush().good();
+        }
+
+        lock.lock();
+        writing = false;
+        failed = failed || !ok;
+        data.clear();
+        spare.push_back(std::move(data));
+        drained.notify_all();
+    }
+}
+
+SearchTraceReader::SearchTraceReader(std::istream &in) : in(in), buffer(readChunk) {
+    char head[sizeof(magic) + 1];
+    header = in.read(head, sizeof(head)) && std::equal(magic, magic + sizeof(magic), head)
+             && static_cast<uint8_t>(head[sizeof(magic)]) == version;
+}
+
+bool SearchTraceReader::refill() {
+    in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    size = static_cast<size_t>(in.gcount());
+    position = 0;
+    return size > 0;
+}
+
+bool SearchTraceReader::readVarint(uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (position == size && !refill())
+            return false;
+        const auto byte = static_cast<uint8_t>(buffer[position++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+bool SearchTraceReader::next(TraceRecord &record) {
+    uint64_t head;
+    if (!header || !readVarint(head))
+        return false;
+    record.kind = static_cast<TraceEvent>(head & 7);
+    record.payload = head >> 3;
+    for (int i = 0; i < fieldCount[head & 7]; i++)
+        if (!readVarint(record.fields[i]))
+            return false;
+    return true;
+}
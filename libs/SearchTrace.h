@@ -0,0 +1,164 @@
+#ifndef SEARCHTRACE_LIBRARY_H
+#define SEARCHTRACE_LIBRARY_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SudokuSolverExport.h"
+
+/**
+ * @file SearchTrace.h
+ * @brief Binary log of what the backtracking search did, for offline analysis.
+ *
+ * With `SudokuSolverAlgorithm::setTracing()` every step of the search is
+ * appended to a trace file:
+ *
+ *     header:  "SDKT", version (1 byte)
+ *     event:   varint `payload * 8 + kind`, then the varints of its kind
+ *
+ * | kind          | payload               | then                          |
+ * |---------------|-----------------------|-------------------------------|
+ * | Begin         | 1 if resuming         | dimension, depth              |
+ * | Decision      | cell                  | number of candidates          |
+ * | UnitDecision  | unit (rows, cols, boxes) | value, number of positions |
+ * | Try           | cell                  | value                         |
+ * | Propagation   | placed * 4 + outcome  | -                             |
+ * | Backtrack     | frames popped         | -                             |
+ * | Solution      | 0                     | -                             |
+ * | End           | 1 if stopped          | solutions, elapsed µs         |
+ *
+ * A Decision pushes a frame, each Try starts one of its alternatives, and
+ * Backtrack pops exhausted frames (all of them on a restart), so the depth
+ * is implicit. The outcome of a Propagation is a TraceOutcome. Most events
+ * take two or three bytes.
+ *
+ * The search writes events into an in-memory block; full blocks go to a
+ * writer thread, so the search never waits for the disk unless it gets
+ * several blocks ahead of it.
+ */
+
+/** Kind of a trace event, in the low 3 bits of its first varint. */
+enum class TraceEvent : uint8_t {
+    Begin = 0,
+    Decision = 1,
+    UnitDecision = 2,
+    Try = 3,
+    Propagation = 4,
+    Backtrack = 5,
+    Solution = 6,
+    End = 7
+};
+
+/** How a propagation batch ended. */
+enum class TraceOutcome : uint8_t {
+    Consistent = 0,
+    Conflict = 1,
+    /** Consistent, but a state already known to have no solution. */
+    DeadState = 2
+};
+
+/**
+ * @brief Appends events to a trace file from a writer thread (internal to the library).
+ *
+ * The event methods are inline and only write to the current block.
+ */
+class SearchTraceWriter {
+public:
+    /** @brief Replaces `path` with an empty trace and starts the writer thread. */
+    explicit SearchTraceWriter(const std::string &path);
+    /** @brief Writes everything appended so far and joins the thread. */
+    ~SearchTraceWriter();
+
+    SearchTraceWriter(const SearchTraceWriter&) = delete;
+    SearchTraceWriter& operator=(const SearchTraceWriter&) = delete;
+
+    /** @brief False if the file could not be created or written. */
+    [[nodiscard]] bool good() const;
+
+    /** @brief Starts an event; its extra fields follow with `field()`. */
+    void event(TraceEvent kind, uint64_t payload) {
+        if (static_cast<size_t>(limit - cursor) < maxEventBytes)
+            handOff();
+        put(payload << 3 | static_cast<uint8_t>(kind));
+    }
+    /** @brief Appends a field to the current event. */
+    void field(uint64_t value) { put(value); }
+
+    /** @brief Hands the current block to the writer thread without waiting. */
+    void handOff();
+    /** @brief Waits until everything appended so far is in the file. */
+    void flush();
+
+private:
+    /** Longest event: three 10-byte varints. */
+    static constexpr size_t maxEventBytes = 30;
+
+    void put(uint64_t value) {
+        while (value >= 0x80) {
+            *cursor++ = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *cursor++ = static_cast<uint8_t>(value);
+    }
+
+    /** @brief Writer thread: writes full blocks in order. */
+    void run();
+
+    std::ofstream file;
+    std::vector<uint8_t> block;
+    uint8_t *cursor = nullptr;
+    uint8_t *limit = nullptr;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable drained;
+    /** Blocks waiting for the writer thread, oldest first. */
+    std::deque<std::vector<uint8_t>> full;
+    /** Written blocks, reused so steady tracing does not allocate. */
+    std::vector<std::vector<uint8_t>> spare;
+    bool writing = false;
+    bool failed = false;
+    bool quit = false;
+    std::thread thread;
+};
+
+/** One decoded trace event; `fields` holds as many values as its kind has (see SearchTrace.h). */
+struct TraceRecord {
+    TraceEvent kind = TraceEvent::Begin;
+    uint64_t payload = 0;
+    uint64_t fields[2] = {0, 0};
+};
+
+/** Reads back a file written with `SudokuSolverAlgorithm::setTracing()`. */
+class SUDOKUSOLVER_EXPORT SearchTraceReader {
+public:
+    /** @brief Reads the header; `valid()` is false if it is not a trace. */
+    explicit SearchTraceReader(std::istream &in);
+
+    [[nodiscard]] bool valid() const { return header; }
+
+    /**
+     * @brief Decodes the next event.
+     * @return false at the end of the trace or on a truncated event.
+     */
+    bool next(TraceRecord &record);
+
+private:
+    bool readVarint(uint64_t &value);
+    bool refill();
+
+    std::istream &in;
+    bool header = false;
+    std::vector<char> buffer;
+    size_t position = 0;
+    size_t size = 0;
+};
+
+#endif // SEARCHTRACE_LIBRARY_H
@@ -0,0 +1,104 @@
+#include "SolutionStream.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr char magic[4] = {'S', 'D', 'K', 'E'};
+constexpr uint8_t version = 1;
+/** I byte accumulati oltre questa soglia passano allo stream */
+constexpr size_t flushThreshold = 64 * 1024;
+
+void putVarint(std::vector<uint8_t> &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+}
+
+SolutionStreamWriter::SolutionStreamWriter(std::ostream &out, unsigned short dimension)
+    : out(out), base(dimension + 1u), previous(static_cast<size_t>(dimension) * dimension, 0) {
+    buffer.reserve(flushThreshold + 1024);
+    buffer.insert(buffer.end(), magic, magic + sizeof(magic));
+    buffer.push_back(version);
+    buffer.push_back(static_cast<uint8_t>(dimension));
+}
+
+SolutionStreamWriter::~SolutionStreamWriter() {
+    flush();
+}
+
+void SolutionStreamWriter::write(std::span<const unsigned short> solution) {
+    const size_t cellCount = std::min(solution.size(), previous.size());
+
+    size_t changed = 0;
+    for (size_t cell = 0; cell < cellCount; cell++)
+        changed += solution[cell] != previous[cell];
+    putVarint(buffer, changed);
+
+    // Ogni cella cambiata: distanza dalla precedente cambiata e nuovo valore in un solo varint
+    size_t next = 0;
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        if (solution[cell] == previous[cell])
+            continue;
+        putVarint(buffer, (cell - next) * base + solution[cell]);
+        previous[cell] = solution[cell];
+        next = cell + 1;
+    }
+    written++;
+
+    if (buffer.size() >= flushThreshold)
+        flush();
+}
+
+void SolutionStreamWriter::flush() {
+    if (buffer.empty())
+        return;
+    out.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+}
+
+SolutionStreamReader::SolutionStreamReader(std::istream &in) : in(in) {
+    char header[sizeof(magic) + 2];
+    if (!in.read(header, sizeof(header)) || !std::equal(magic, magic + sizeof(magic), header)
+        || static_cast<uint8_t>(header[4]) != version || header[5] == 0)
+        return;
+    dim = static_cast<uint8_t>(header[5]);
+    current.assign(static_cast<size_t>(dim) * dim, 0);
+}
+
+bool SolutionStreamReader::readVarint(uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const int byte = in.get();
+        if (byte == std::istream::traits_type::eof())
+            return false;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+bool SolutionStreamReader::next(std::vector<unsigned short> &solution) {
+    uint64_t changed = 0;
+    if (!valid() || !readVarint(changed) || changed > current.size())
+        return false;
+
+    size_t cell = 0;
+    for (uint64_t i = 0; i < changed; i++) {
+        uint64_t packed = 0;
+        if (!readVarint(packed))
+            return false;
+        const uint64_t gap = packed / (dim + 1u);
+        if (gap >= current.size() - cell)
+            return false;
+        cell += gap;
+        current[cell++] = static_cast<unsigned short>(packed % (dim + 1u));
+    }
+    solution = current;
+    return true;
+}
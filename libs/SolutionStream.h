@@ -0,0 +1,83 @@
+#ifndef SOLUTIONSTREAM_LIBRARY_H
+#define SOLUTIONSTREAM_LIBRARY_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <vector>
+
+#include "SudokuSolverExport.h"
+
+/**
+ * @file SolutionStream.h
+ * @brief Compact binary format for long lists of solutions of the same puzzle.
+ *
+ * Solutions enumerated depth-first differ from the previous one in only a few
+ * cells, so each one is written as the list of cells that changed:
+ *
+ *     header:   "SDKE", version (1 byte), dimension (1 byte)
+ *     solution: number of changed cells, then for each changed cell
+ *               `gap * (dimension + 1) + value`, where gap counts the
+ *               unchanged cells since the previous changed one
+ *
+ * Numbers are LEB128 varints, so a nearby change costs one byte; the first
+ * solution is diffed against an empty grid. A 9x9 enumeration takes about
+ * 11 bytes per solution instead of 81. The stream has no trailer: it ends
+ * with the last solution.
+ */
+class SUDOKUSOLVER_EXPORT SolutionStreamWriter {
+public:
+    /** @brief Writes the header; solutions follow with `write()`. */
+    SolutionStreamWriter(std::ostream &out, unsigned short dimension);
+    /** @brief Flushes the buffered solutions. */
+    ~SolutionStreamWriter();
+
+    SolutionStreamWriter(const SolutionStreamWriter&) = delete;
+    SolutionStreamWriter& operator=(const SolutionStreamWriter&) = delete;
+
+    /** @brief Appends a solution, row-major, `dimension * dimension` values. */
+    void write(std::span<const unsigned short> solution);
+    /** @brief Hands the buffered bytes to the stream. */
+    void flush();
+
+    /** @brief Solutions written so far. */
+    [[nodiscard]] uint64_t count() const { return written; }
+
+private:
+    std::ostream &out;
+    /** Values per cell plus one: the multiplier of the gap. */
+    const uint64_t base;
+    /** Previous solution, the base of the next diff. */
+    std::vector<unsigned short> previous;
+    /** Encoded solutions not handed to the stream yet. */
+    std::vector<uint8_t> buffer;
+    uint64_t written = 0;
+};
+
+/** Reads back a stream written by SolutionStreamWriter. */
+class SUDOKUSOLVER_EXPORT SolutionStreamReader {
+public:
+    /** @brief Reads the header; `valid()` is false if it is not a solution stream. */
+    explicit SolutionStreamReader(std::istream &in);
+
+    [[nodiscard]] bool valid() const { return dim != 0; }
+    [[nodiscard]] unsigned short dimension() const { return dim; }
+
+    /**
+     * @brief Decodes the next solution.
+     * @param solution Resized to `dimension * dimension` values, row-major.
+     * @return false at the end of the stream or on corrupt data.
+     */
+    bool next(std::vector<unsigned short> &solution);
+
+private:
+    /** @brief Reads a varint; false on a truncated one. */
+    bool readVarint(uint64_t &value);
+
+    std::istream &in;
+    unsigned short dim = 0;
+    std::vector<unsigned short> current;
+};
+
+#endif // SOLUTIONSTREAM_LIBRARY_H
@@ -0,0 +1,77 @@
+#ifndef SOLVERARENA_LIBRARY_H
+#define SOLVERARENA_LIBRARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * @file SolverArena.h
+ * @brief Single-buffer bump allocator holding the whole state of a solver.
+ *
+ * The arena is carved in two passes: a measuring pass on an empty arena only
+ * adds up the sizes (`take()` returns nullptr), then `reserve()` allocates the
+ * total once and a second pass hands out the actual regions. Carving again for
+ * the same (or a smaller) size reuses the buffer without allocating.
+ */
+class SolverArena {
+public:
+    /** Alignment of every region; enough for any scalar the solver stores. */
+    static constexpr size_t alignment = alignof(std::max_align_t);
+
+    /**
+     * @brief Makes room for `bytes` bytes, keeping the buffer if it is large enough.
+     * @return true if a new buffer had to be allocated.
+     */
+    bool reserve(size_t bytes) {
+        used = 0;
+        if (bytes <= capacity)
+            return false;
+
+        buffer.reset(new std::byte[bytes + alignment]);
+        capacity = bytes;
+        return true;
+    }
+
+    /** @brief Starts a new carving pass from the beginning of the buffer. */
+    void rewind() { used = 0; }
+
+    /** @brief Starts a measuring pass: `take()` only counts bytes. */
+    void measure() { measuring = true; used = 0; }
+
+    /** @brief Ends a measuring pass. @return Bytes needed by the regions taken. */
+    size_t measured() { measuring = false; return std::exchange(used, 0); }
+
+    /**
+     * @brief Next region of `count` objects of a trivial type T.
+     * @return The region, or nullptr in a measuring pass.
+     */
+    template <class T>
+    T *take(size_t count) {
+        used = (used + alignment - 1) / alignment * alignment;
+        const size_t offset = used;
+        used += count * sizeof(T);
+
+        if (measuring)
+            return nullptr;
+        return reinterpret_cast<T *>(base() + offset);
+    }
+
+    /** @brief Bytes currently allocated. */
+    [[nodiscard]] size_t bytes() const { return capacity; }
+
+private:
+    /** @brief First aligned byte of the buffer. */
+    std::byte *base() const {
+        const auto address = reinterpret_cast<std::uintptr_t>(buffer.get());
+        return buffer.get() + ((alignment - address % alignment) % alignment);
+    }
+
+    std::unique_ptr<std::byte[]> buffer;
+    size_t capacity = 0;
+    size_t used = 0;
+    bool measuring = false;
+};
+
+#endif // SOLVERARENA_LIBRARY_H
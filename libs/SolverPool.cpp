@@ -0,0 +1,53 @@
+#include "SolverPool.h"
+
+#include <algorithm>
+
+SolverPool::~SolverPool() {
+    for (SudokuSolverAlgorithm *solver : idle)
+        delete solver;
+}
+
+SolverPool::Handle SolverPool::acquire(unsigned short dimension) {
+    SudokuSolverAlgorithm *solver = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (!idle.empty()) {
+            // Meglio un solver già usato a questa dimensione: la sua arena va bene così
+            auto it = std::find_if(idle.begin(), idle.end(),
+                                   [dimension](const SudokuSolverAlgorithm *s) { return s->size() == dimension; });
+            if (it == idle.end())
+                it = idle.end() - 1;
+
+            solver = *it;
+            *it = idle.back();
+            idle.pop_back();
+        }
+    }
+
+    if (solver)
+        solver->reset(dimension);
+    else
+        solver = new SudokuSolverAlgorithm(dimension);
+
+    return Handle(solver, Release{this});
+}
+
+size_t SolverPool::idleCount() const {
+    std::lock_guard<std::mutex> guard(mutex);
+    return idle.size();
+}
+
+void SolverPool::release(SudokuSolverAlgorithm *solver) {
+    // Il prossimo che lo prende lo trova come nuovo: niente stop rimasto pendente,
+    // né opzioni, tracce, checkpoint o tabella degli stati morti di chi l'ha usato
+    solver->clearStopRequest();
+    solver->setProgressListener({});
+    solver->setProgressRecording(true);
+    solver->setSearchOptions({});
+    solver->setTracing("");
+    solver->setCheckpointing("");
+    solver->setDeadStateTable(0);
+
+    std::lock_guard<std::mutex> guard(mutex);
+    idle.push_back(solver);
+}
@@ -0,0 +1,60 @@
+#ifndef SOLVERPOOL_LIBRARY_H
+#define SOLVERPOOL_LIBRARY_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "SudokuSolverAlgorithm.h"
+
+/**
+ * @file SolverPool.h
+ * @brief Recycles solvers, so a long-running host stops allocating after warm-up.
+ *
+ * `acquire()` hands out an idle solver reset to the requested size; the handle
+ * returns it to the pool when it goes out of scope. A returned solver is put
+ * back to the settings of a new one: no pending stop, progress listener,
+ * search options, trace, checkpoint file or dead-state table carry over to
+ * the next borrower. A solver keeps its arena
+ * and progress capacity across uses, so a loop of acquire/insert/solve at a
+ * fixed size allocates nothing once every solver has run once.
+ *
+ * The pool is thread-safe; it must outlive the handles it returned.
+ */
+class SUDOKUSOLVER_EXPORT SolverPool {
+public:
+    /** Returns a solver to its pool instead of deleting it. */
+    struct Release {
+        SolverPool *pool = nullptr;
+        void operator()(SudokuSolverAlgorithm *solver) const { pool->release(solver); }
+    };
+
+    /** A solver on loan from the pool. */
+    using Handle = std::unique_ptr<SudokuSolverAlgorithm, Release>;
+
+    SolverPool() = default;
+    ~SolverPool();
+
+    SolverPool(const SolverPool&) = delete;
+    SolverPool& operator=(const SolverPool&) = delete;
+
+    /**
+     * @brief An empty solver of the given size, reused if one is idle.
+     * @param dimension Grid size (e.g., 9 for 9x9).
+     *
+     * Idle solvers last used at this size are preferred: their memory fits as is.
+     */
+    Handle acquire(unsigned short dimension);
+
+    /** @brief Number of idle solvers. */
+    [[nodiscard]] size_t idleCount() const;
+
+private:
+    /** @brief Puts a solver back in the idle list. */
+    void release(SudokuSolverAlgorithm *solver);
+
+    mutable std::mutex mutex;
+    std::vector<SudokuSolverAlgorithm *> idle;
+};
+
+#endif // SOLVERPOOL_LIBRARY_H
@@ -1,42 +1,469 @@
 #include "SudokuSolverAlgorithm.h"
 
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <climits>
+#include <thread>
+
+#include "CheckpointWriter.h"
+#include "SatSolver.h"
+#include "SearchTrace.h"
+#include "SolutionStream.h"
+
 SudokuSolverAlgorithm::SudokuSolverAlgorithm(const unsigned short & dim) {
+    reset(dim);
+}
+
+SudokuSolverAlgorithm::~SudokuSolverAlgorithm() = default;
+
+void SudokuSolverAlgorithm::reset(unsigned short dim) {
     this->dimension = dim;
     // Calcoliamo la dimensione del blocco (es. sqrt(9) = 3)
     this->blockSize = static_cast<unsigned short>(std::sqrt(dim));
 
-    grid = new unsigned short*[dimension];
-    for (unsigned short i = 0; i < dimension; i++) {
-        grid[i] = new unsigned short[dimension];
-        // FIX 1: Inizializzazione a 0 (vuoto)
-        for (unsigned short j = 0; j < dimension; j++) {
-            grid[i][j] = 0;
+    // Prima si misura, poi si ritaglia: il buffer si rialloca solo se non basta
+    arena.measure();
+    carveArena();
+    if (arena.reserve(arena.measured()))
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    carveArena();
+
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+    std::fill_n(grid, cellCount, 0);
+    std::fill_n(given, cellCount, 0);
+    std::fill_n(eliminated, cellCount, 0);
+    eliminationCount = 0;
+    solvedInGrid = false;
+    hasSolution = false;
+    trailSize = 0;
+    suspended = false;
+    stats = {};
+
+    // Tabelle fisse della dimensione: condivise da tutti i solver della stessa dimensione
+    if (!tables || tables->dimension != dimension) {
+        tables = Tables::forDimension(dimension);
+        deadStates.clear();
+    }
+    rowOf = tables->rowOf.data();
+    colOf = tables->colOf.data();
+    boxOf = tables->boxOf.data();
+    units = tables->units.data();
+
+    clearProgress();
+}
+
+SudokuSolverAlgorithm::SudokuSolverAlgorithm(const SudokuSolverAlgorithm &other) {
+    reset(other.dimension);
+    copyFrom(other);
+}
+
+SudokuSolverAlgorithm& SudokuSolverAlgorithm::operator=(const SudokuSolverAlgorithm &other) {
+    if (this != &other) {
+        reset(other.dimension);
+        copyFrom(other);
+    }
+    return *this;
+}
+
+std::unique_ptr<SudokuSolverAlgorithm> SudokuSolverAlgorithm::clone() const {
+    return std::make_unique<SudokuSolverAlgorithm>(*this);
+}
+
+void SudokuSolverAlgorithm::copyFrom(const SudokuSolverAlgorithm &other) {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+    std::copy_n(other.grid, cellCount, grid);
+    std::copy_n(other.given, cellCount, given);
+    solvedInGrid = other.solvedInGrid;
+
+    // La soluzione in cache si condivide: verrà copiata solo da chi la riscrive
+    solution = other.solution;
+    hasSolution = other.hasSolution;
+}
+
+SolverState SudokuSolverAlgorithm::snapshot() const {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+
+    SolverState state;
+    state.dim = dimension;
+    state.block = blockSize;
+    state.solved = solvedInGrid;
+    state.bytes.resize(SolverState::bytesFor(dimension));
+
+    // Un solo buffer: valori (un byte per cella), indizi (un bit per cella), maschere
+    uint8_t *values = state.bytes.data();
+    uint64_t *clues = state.clueWords();
+    uint64_t *masks = state.masks();
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        values[cell] = static_cast<uint8_t>(grid[cell]);
+        if (given[cell])
+            clues[cell / 64] |= 1ULL << (cell % 64);
+        if (grid[cell]) {
+            const uint64_t bit = 1ULL << (grid[cell] - 1);
+            masks[rowOf[cell]] |= bit;
+            masks[dimension + colOf[cell]] |= bit;
+            masks[2 * dimension + boxOf[cell]] |= bit;
+        }
+    }
+
+    if (hasSolution)
+        state.solution = solution;
+    return state;
+}
+
+void SudokuSolverAlgorithm::restore(const SolverState &state) {
+    if (state.dim != dimension)
+        reset(state.dim);
+
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+    const uint8_t *values = state.bytes.data();
+    const uint64_t *clues = state.clueWords();
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        grid[cell] = values[cell];
+        given[cell] = (clues[cell / 64] >> (cell % 64)) & 1;
+    }
+    solvedInGrid = state.solved;
+    suspended = false;
+
+    // Condivisa in sola lettura: writableSolution() la copia prima di riscriverla
+    hasSolution = static_cast<bool>(state.solution);
+    if (hasSolution)
+        solution = std::const_pointer_cast<std::vector<unsigned short>>(state.solution);
+}
+
+namespace {
+    // Formato binario della sessione: interi little-endian, un byte per valore
+    constexpr uint8_t sessionMagic[4] = {'S', 'D', 'K', 'S'};
+    // Versione 2: statistiche della ricerca interrotta; 3: tagli della tabella degli stati morti; 4: riavvii;
+    // 5: limite e soluzioni trovate su 8 byte
+    constexpr uint8_t sessionVersion = 5;
+
+    enum SessionFlags : uint8_t {
+        SolvedInGrid = 0x1,
+        HasSolution = 0x2,
+        Suspended = 0x4,
+        Consistent = 0x8,
+        Warm = 0x10,
+        Record = 0x20
+    };
+
+    // Termine i (da 0) della successione di Luby: 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ...
+    uint64_t lubyTerm(uint64_t i) {
+        uint64_t size = 1;
+        uint64_t power = 1;
+        while (size < i + 1) {
+            size = 2 * size + 1;
+            power *= 2;
+        }
+        while (size - 1 != i) {
+            size = (size - 1) / 2;
+            power /= 2;
+            i %= size;
+        }
+        return power;
+    }
+
+    void putUint(std::vector<uint8_t> &out, uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; i++)
+            out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+
+    // Legge senza mai uscire dal buffer: dopo il primo errore `ok` resta false
+    struct ByteReader {
+        std::span<const uint8_t> data;
+        size_t at = 0;
+        bool ok = true;
+
+        uint64_t uint(int bytes) {
+            if (!ok || data.size() - at < static_cast<size_t>(bytes)) {
+                ok = false;
+                return 0;
+            }
+            uint64_t v = 0;
+            for (int i = 0; i < bytes; i++)
+                v |= static_cast<uint64_t>(data[at++]) << (8 * i);
+            return v;
+        }
+        const uint8_t *bytes(size_t count) {
+            if (!ok || data.size() - at < count) {
+                ok = false;
+                return nullptr;
+            }
+            at += count;
+            return data.data() + at - count;
+        }
+    };
+}
+
+void SudokuSolverAlgorithm::serialize(std::vector<uint8_t> &out) const {
+    writeState(out, suspended ? &suspension : nullptr, stats);
+}
+
+void SudokuSolverAlgorithm::writeState(std::vector<uint8_t> &out, const Suspension *search,
+                                       const SearchStatistics &statistics) const {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+
+    uint8_t flags = 0;
+    if (solvedInGrid) flags |= SolvedInGrid;
+    if (hasSolution) flags |= HasSolution;
+    if (search) {
+        flags |= Suspended;
+        if (search->consistent) flags |= Consistent;
+        if (search->warm) flags |= Warm;
+        if (search->record) flags |= Record;
+    }
+
+    out.insert(out.end(), std::begin(sessionMagic), std::end(sessionMagic));
+    out.push_back(sessionVersion);
+    out.push_back(static_cast<uint8_t>(dimension));
+    out.push_back(flags);
+
+    // Valori, poi gli indizi come bit
+    for (size_t cell = 0; cell < cellCount; cell++)
+        out.push_back(static_cast<uint8_t>(grid[cell]));
+    const size_t clueStart = out.size();
+    out.resize(clueStart + (cellCount + 7) / 8, 0);
+    for (size_t cell = 0; cell < cellCount; cell++)
+        if (given[cell])
+            out[clueStart + cell / 8] |= static_cast<uint8_t>(1u << (cell % 8));
+
+    if (hasSolution)
+        for (size_t cell = 0; cell < cellCount; cell++)
+            out.push_back(static_cast<uint8_t>((*solution)[cell]));
+
+    if (!search)
+        return;
+
+    // Ricerca interrotta: copia di lavoro, celle riempite in ordine e pila delle decisioni.
+    // Le maschere dei candidati non servono: si ricalcolano dalla copia di lavoro.
+    putUint(out, search->limit, 8);
+    putUint(out, search->found, 8);
+    for (size_t cell = 0; cell < cellCount; cell++)
+        out.push_back(static_cast<uint8_t>(value[cell]));
+    putUint(out, placedCount, 2);
+    for (size_t i = 0; i < placedCount; i++)
+        putUint(out, placed[i], 2);
+    putUint(out, trailSize, 2);
+    for (size_t i = 0; i < trailSize; i++) {
+        putUint(out, trail[i].cell, 2);
+        putUint(out, trail[i].remaining, 8);
+        putUint(out, trail[i].mark, 2);
+        out.push_back(static_cast<uint8_t>(trail[i].value));
+    }
+    if (search->warm)
+        for (size_t cell = 0; cell < cellCount; cell++)
+            out.push_back(static_cast<uint8_t>(phase[cell]));
+
+    putUint(out, statistics.decisions, 8);
+    putUint(out, statistics.conflicts, 8);
+    putUint(out, statistics.placements, 8);
+    putUint(out, static_cast<uint64_t>(statistics.elapsed.count()), 8);
+    putUint(out, statistics.deadStateHits, 8);
+    putUint(out, statistics.restarts, 8);
+}
+
+bool SudokuSolverAlgorithm::deserialize(std::span<const uint8_t> data) {
+    ByteReader in{data};
+    const uint8_t *magic = in.bytes(sizeof(sessionMagic));
+    const auto version = in.uint(1);
+    const auto dim = static_cast<unsigned short>(in.uint(1));
+    const auto flags = static_cast<uint8_t>(in.uint(1));
+    if (!in.ok || !std::equal(std::begin(sessionMagic), std::end(sessionMagic), magic)
+        || version < 1 || version > sessionVersion)
+        return false;
+
+    const auto block = static_cast<unsigned short>(std::sqrt(dim));
+    if (dim == 0 || dim > 64 || block * block != dim)
+        return false;
+
+    reset(dim);
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+
+    // Un valore fuori scala o un indice fuori griglia rende il file non valido
+    bool valid = true;
+    auto readValues = [&](unsigned short *target) {
+        const uint8_t *bytes = in.bytes(cellCount);
+        for (size_t cell = 0; bytes && cell < cellCount; cell++) {
+            valid = valid && bytes[cell] <= dimension;
+            target[cell] = bytes[cell];
         }
+    };
+
+    readValues(grid);
+    if (const uint8_t *clues = in.bytes((cellCount + 7) / 8))
+        for (size_t cell = 0; cell < cellCount; cell++)
+            given[cell] = (clues[cell / 8] >> (cell % 8)) & 1;
+    solvedInGrid = flags & SolvedInGrid;
+
+    if (flags & HasSolution) {
+        readValues(writableSolution());
+        hasSolution = true;
+    }
+
+    if (flags & Suspended) {
+        if (version >= 5) {
+            suspension.limit = static_cast<unsigned long>(in.uint(8));
+            suspension.found = static_cast<unsigned long>(in.uint(8));
+        } else {
+            // Fino alla versione 4 erano 4 byte: un limite tutto a uno era ULONG_MAX troncato
+            const uint64_t limit = in.uint(4);
+            suspension.limit = limit == UINT32_MAX ? ULONG_MAX : static_cast<unsigned long>(limit);
+            suspension.found = static_cast<unsigned long>(in.uint(4));
+        }
+        suspension.consistent = flags & Consistent;
+        suspension.warm = flags & Warm;
+        suspension.record = flags & Record;
+
+        readValues(value);
+        placedCount = static_cast<size_t>(in.uint(2));
+        valid = valid && placedCount <= cellCount;
+        for (size_t i = 0; valid && in.ok && i < placedCount; i++) {
+            placed[i] = static_cast<unsigned short>(in.uint(2));
+            valid = placed[i] < cellCount && value[placed[i]] && !given[placed[i]];
+        }
+        trailSize = static_cast<size_t>(in.uint(2));
+        valid = valid && trailSize <= cellCount;
+        for (size_t i = 0; valid && in.ok && i < trailSize; i++) {
+            Frame &frame = trail[i];
+            frame.cell = static_cast<unsigned short>(in.uint(2));
+            frame.remaining = in.uint(8) & (dimension >= 64 ? ~0ULL : (1ULL << dimension) - 1);
+            frame.mark = static_cast<unsigned int>(in.uint(2));
+            frame.value = static_cast<unsigned short>(in.uint(1));
+            frame.eliminationMark = 0;
+            valid = frame.mark <= placedCount && frame.value <= dimension
+                    && frame.cell < (frame.value ? 3 * dimension : cellCount);
+        }
+        if (suspension.warm)
+            readValues(phase);
+        if (version >= 2) {
+            stats.decisions = in.uint(8);
+            stats.conflicts = in.uint(8);
+            stats.placements = in.uint(8);
+            stats.elapsed = std::chrono::nanoseconds(static_cast<int64_t>(in.uint(8)));
+        }
+        if (version >= 3)
+            stats.deadStateHits = in.uint(8);
+        if (version >= 4)
+            stats.restarts = in.uint(8);
+        suspended = valid && suspension.limit > 0 && (suspension.consistent || trailSize > 0);
+        enumerating = false;
+    }
+
+    if (!in.ok || !valid) {
+        reset(dim);
+        return false;
+    }
+    return true;
+}
+
+unsigned short *SudokuSolverAlgorithm::writableSolution() {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+
+    // Copy-on-write: la si riscrive sul posto solo se nessuno la condivide
+    if (!solution || solution.use_count() > 1 || solution->size() != cellCount) {
+        solution = std::make_shared<std::vector<unsigned short>>(cellCount);
+        allocations.fetch_add(1, std::memory_order_relaxed);
     }
+    return solution->data();
 }
 
-SudokuSolverAlgorithm::~SudokuSolverAlgorithm() {
-    for (unsigned short i = 0; i < dimension; ++i) {
-        delete [] grid[i];
+std::shared_ptr<const SudokuSolverAlgorithm::Tables> SudokuSolverAlgorithm::Tables::forDimension(unsigned short dimension) {
+    static std::mutex cacheMutex;
+    static std::vector<std::shared_ptr<const Tables>> cache;
+
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    for (const auto &tables : cache)
+        if (tables->dimension == dimension)
+            return tables;
+
+    auto tables = std::make_shared<Tables>();
+    const auto blockSize = static_cast<unsigned short>(std::sqrt(dimension));
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+    tables->dimension = dimension;
+    tables->rowOf.resize(cellCount);
+    tables->colOf.resize(cellCount);
+    tables->boxOf.resize(cellCount);
+    tables->units.resize(3 * cellCount);
+
+    // Tabelle fisse della dimensione: niente divisioni nel ciclo di ricerca
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        tables->rowOf[cell] = static_cast<unsigned short>(cell / dimension);
+        tables->colOf[cell] = static_cast<unsigned short>(cell % dimension);
+        tables->boxOf[cell] = static_cast<unsigned short>((tables->rowOf[cell] / blockSize) * blockSize + tables->colOf[cell] / blockSize);
     }
-    delete [] grid;
+    for (unsigned short box = 0; box < dimension; box++)
+        for (unsigned short k = 0; k < dimension; k++) {
+            const unsigned short row = (box / blockSize) * blockSize + k / blockSize;
+            const unsigned short col = (box % blockSize) * blockSize + k % blockSize;
+            tables->units[static_cast<size_t>(k) + box * dimension + 2 * cellCount] = row * dimension + col;
+        }
+    for (unsigned short line = 0; line < dimension; line++)
+        for (unsigned short k = 0; k < dimension; k++) {
+            tables->units[static_cast<size_t>(line) * dimension + k] = line * dimension + k;
+            tables->units[cellCount + static_cast<size_t>(line) * dimension + k] = k * dimension + line;
+        }
+
+    // Chiavi Zobrist: sequenza splitmix64 a seme fisso, uguale in ogni esecuzione
+    tables->zobrist.resize(cellCount * dimension);
+    uint64_t seed = 0x5D0C0DE5EEDULL + dimension;
+    for (uint64_t &key : tables->zobrist) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        key = z ^ (z >> 31);
+    }
+
+    cache.push_back(tables);
+    return tables;
+}
+
+void SudokuSolverAlgorithm::carveArena() {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+
+    // Stato del puzzle
+    grid = arena.take<unsigned short>(cellCount);
+    given = arena.take<unsigned char>(cellCount);
+
+    // Spazio di lavoro della ricerca
+    value = arena.take<unsigned short>(cellCount);
+    phase = arena.take<unsigned short>(cellCount);
+    empty = arena.take<unsigned short>(cellCount);
+    placed = arena.take<unsigned short>(cellCount);
+    cand = arena.take<uint64_t>(cellCount);
+    rowUsed = arena.take<uint64_t>(dimension);
+    colUsed = arena.take<uint64_t>(dimension);
+    boxUsed = arena.take<uint64_t>(dimension);
+    trail = arena.take<Frame>(cellCount);
+    eliminated = arena.take<uint64_t>(cellCount);
+    // Ogni candidato si toglie al più una volta lungo un ramo
+    eliminations = arena.take<Elimination>(cellCount * dimension);
+    pending = arena.take<ProgressStep>(progressBatch);
+}
+
+size_t SudokuSolverAlgorithm::allocationCount() const {
+    return allocations.load(std::memory_order_relaxed);
 }
 
 void SudokuSolverAlgorithm::insert(const unsigned short & value, const unsigned short & row, const unsigned short & column) {
     if (row < dimension && column < dimension && value > 0 && value <= dimension) {
-        grid[row][column] = value;
+        // Un indizio modificato invalida i valori risolti, non la soluzione in cache
+        if (solvedInGrid)
+            resetToClues();
+        grid[row * dimension + column] = value;
+        given[row * dimension + column] = 1;
+        suspended = false;
     }
 }
 
 bool SudokuSolverAlgorithm::isSafe(const unsigned short & row, const unsigned short & col, const unsigned short & num) const {
     // Controlla se il numero esiste già nella riga (escludendo la cella corrente)
     for (unsigned short x = 0; x < dimension; x++) {
-        if (x != col && grid[row][x] == num) return false;
+        if (x != col && grid[row * dimension + x] == num) return false;
     }
 
     // Controlla se il numero esiste già nella colonna (escludendo la cella corrente)
     for (unsigned short x = 0; x < dimension; x++) {
-        if (x != row && grid[x][col] == num) return false;
+        if (x != row && grid[x * dimension + col] == num) return false;
     }
 
     // Controlla il blocco (quadrato)
@@ -47,7 +474,7 @@ bool SudokuSolverAlgorithm::isSafe(const unsigned short & row, const unsigned sh
         for (unsigned short j = 0; j < blockSize; j++) {
             unsigned short currRow = startRow + i;
             unsigned short currCol = startCol + j;
-            if (!(currRow == row && currCol == col) && grid[currRow][currCol] == num) {
+            if (!(currRow == row && currCol == col) && grid[currRow * dimension + currCol] == num) {
                 return false;
             }
         }
@@ -56,91 +483,1493 @@ bool SudokuSolverAlgorithm::isSafe(const unsigned short & row, const unsigned sh
     return true;
 }
 
-bool SudokuSolverAlgorithm::solve() {
-    // Wrapper pubblico per avviare la ricorsione dalla prima cella
+bool SudokuSolverAlgorithm::solve(Engine engine) {
+    // Wrapper pubblico: si riparte sempre dai soli indizi
 
     //printGrid();
 
-    if (!checkAll()) 
+    resetToClues();
+
+    bool ok = false;
+    if (!checkAll()) {
+        ok = false;
+    } else if (solutionFitsClues()) {
+        // Avvio a caldo: la soluzione precedente rispetta ancora tutti gli indizi
+        std::copy_n(solution->data(), static_cast<size_t>(dimension) * dimension, grid);
+        solvedInGrid = true;
+        ok = true;
+    } else if (engine == Engine::Sat) {
+        ok = searchSat(1) == 1;
+    } else {
+        ok = search(1, progressEnabled.load() || progressListener) == 1;
+    }
+
+    stopRequested.store(false);
+    return ok;
+}
+
+unsigned long SudokuSolverAlgorithm::countSolutions(unsigned long limit, Engine engine) {
+    resetToClues();
+
+    unsigned long found = 0;
+    if (limit > 0 && checkAll())
+        found = engine == Engine::Sat ? searchSat(limit) : search(limit, false);
+
+    stopRequested.store(false);
+    return found;
+}
+
+unsigned long SudokuSolverAlgorithm::enumerateSolutions(const SolutionCallback &callback, unsigned int threads) {
+    resetToClues();
+    if (!checkAll()) {
+        stopRequested.store(false);
+        return 0;
+    }
+
+    if (threads <= 1) {
+        solutionVisitor = &callback;
+        const unsigned long found = search(ULONG_MAX, false);
+        solutionVisitor = nullptr;
+        enumerating = suspended;
+        stopRequested.store(false);
+        return found;
+    }
+
+    // Sottoalberi disgiunti, alcuni per thread: chi finisce prima ne prende un altro
+    const std::vector<std::vector<unsigned short>> subproblems = splitClues(static_cast<size_t>(threads) * 8);
+    std::vector<std::unique_ptr<SudokuSolverAlgorithm>> workers;
+    for (unsigned int t = 0; t < threads; t++) {
+        workers.push_back(std::make_unique<SudokuSolverAlgorithm>(dimension));
+        workers.back()->setProgressRecording(false);
+        workers.back()->setSearchOptions(options);
+    }
+
+    std::mutex deliver;
+    std::atomic<size_t> nextSubproblem{0};
+    std::atomic<bool> stopAll{false};
+    unsigned long delivered = 0;
+
+    // Le soluzioni arrivano una alla volta; se il chiamante si ferma, si fermano tutti
+    const SolutionCallback serialized = [&](std::span<const unsigned short> found) {
+        const std::lock_guard<std::mutex> lock(deliver);
+        if (stopAll.load())
+            return false;
+        delivered++;
+        if (!callback(found)) {
+            stopAll.store(true);
+            for (const auto &worker : workers)
+                worker->requestStop();
+            return false;
+        }
+        return true;
+    };
+    auto work = [&](SudokuSolverAlgorithm &worker) {
+        for (size_t i = nextSubproblem++; i < subproblems.size() && !stopAll.load(); i = nextSubproblem++) {
+            worker.reset(dimension);
+            for (size_t cell = 0; cell < subproblems[i].size(); cell++)
+                if (subproblems[i][cell] != 0)
+                    worker.insert(subproblems[i][cell], static_cast<unsigned short>(cell / dimension),
+                                  static_cast<unsigned short>(cell % dimension));
+            worker.enumerateSolutions(serialized);
+        }
+    };
+
+    // Anche la richiesta di stop del chiamante arriva a tutti i thread
+    std::thread watcher;
+    std::atomic<bool> finished{false};
+    watcher = std::thread([&] {
+        while (!finished.load() && !stopRequested.load())
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (stopRequested.load()) {
+            stopAll.store(true);
+            for (const auto &worker : workers)
+                worker->requestStop();
+        }
+    });
+
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++)
+        pool.emplace_back(work, std::ref(*workers[t]));
+    work(*workers[0]);
+    for (std::thread &t : pool)
+        t.join();
+    finished.store(true);
+    watcher.join();
+
+    stopRequested.store(false);
+    return delivered;
+}
+
+unsigned long SudokuSolverAlgorithm::enumerateSolutions(std::ostream &out, unsigned int threads) {
+    SolutionStreamWriter writer(out, dimension);
+    return enumerateSolutions([&writer](std::span<const unsigned short> found) {
+        writer.write(found);
+        return true;
+    }, threads);
+}
+
+bool SudokuSolverAlgorithm::nextSolution() {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+
+    // Ci si ferma alla prima soluzione: la ricerca resta sospesa lì, pronta per la prossima
+    bool produced = false;
+    const SolutionCallback pause = [&produced](std::span<const unsigned short>) {
+        produced = true;
         return false;
+    };
+    solutionVisitor = &pause;
+    if (enumerating && suspended) {
+        search(suspension.limit, false, true);
+    } else {
+        resetToClues();
+        if (checkAll())
+            search(ULONG_MAX, false);
+    }
+    solutionVisitor = nullptr;
+    enumerating = suspended;
+    stopRequested.store(false);
+
+    // La griglia mostra la soluzione appena trovata, non la prima
+    if (produced) {
+        std::copy_n(value, cellCount, grid);
+        solvedInGrid = true;
+    }
+    return produced;
+}
+
+std::vector<std::vector<unsigned short>> SudokuSolverAlgorithm::splitClues(size_t target) const {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+    const uint64_t all = dimension >= 64 ? ~0ULL : (1ULL << dimension) - 1;
+
+    std::vector<std::vector<unsigned short>> level;
+    level.emplace_back(cellCount, 0);
+    for (size_t cell = 0; cell < cellCount; cell++)
+        level[0][cell] = given[cell] ? grid[cell] : 0;
+
+    std::vector<uint64_t> rows(dimension), cols(dimension), boxes(dimension);
+    // Qualche livello basta: ogni livello moltiplica i sottoproblemi per i candidati della cella scelta
+    for (int depth = 0; depth < 16 && level.size() < target; depth++) {
+        std::vector<std::vector<unsigned short>> next;
+        bool split = false;
+        for (std::vector<unsigned short> &clues : level) {
+            std::fill(rows.begin(), rows.end(), 0);
+            std::fill(cols.begin(), cols.end(), 0);
+            std::fill(boxes.begin(), boxes.end(), 0);
+            for (size_t cell = 0; cell < cellCount; cell++) {
+                if (clues[cell] == 0)
+                    continue;
+                const uint64_t bit = 1ULL << (clues[cell] - 1);
+                rows[rowOf[cell]] |= bit;
+                cols[colOf[cell]] |= bit;
+                boxes[boxOf[cell]] |= bit;
+            }
+
+            int best = -1;
+            uint64_t bestMask = 0;
+            for (size_t cell = 0; cell < cellCount; cell++) {
+                if (clues[cell] != 0)
+                    continue;
+                const uint64_t mask = all & ~(rows[rowOf[cell]] | cols[colOf[cell]] | boxes[boxOf[cell]]);
+                if (best < 0 || std::popcount(mask) < std::popcount(bestMask)) {
+                    best = static_cast<int>(cell);
+                    bestMask = mask;
+                    if (std::popcount(mask) <= 1)
+                        break;
+                }
+            }
+            if (best < 0) {
+                next.push_back(std::move(clues));
+                continue;
+            }
+            // Una cella senza candidati: il sottoproblema non ha soluzioni
+            for (uint64_t mask = bestMask; mask; mask &= mask - 1) {
+                std::vector<unsigned short> branch = clues;
+                branch[best] = static_cast<unsigned short>(std::countr_zero(mask) + 1);
+                next.push_back(std::move(branch));
+            }
+            split = split || std::popcount(bestMask) != 1;
+        }
+        level = std::move(next);
+        if (!split)
+            break;
+    }
+    return level;
+}
+
+void SudokuSolverAlgorithm::requestStop() {
+    stopRequested.store(true);
+}
 
-    return solveRecursive(0, 0);
+void SudokuSolverAlgorithm::clearStopRequest() {
+    stopRequested.store(false);
 }
 
-bool SudokuSolverAlgorithm::solveRecursive(unsigned short row, unsigned short column) {
-    // Caso base: abbiamo superato l'ultima riga
-    if (row == dimension) {
+bool SudokuSolverAlgorithm::canResume() const {
+    return suspended;
+}
+
+unsigned long SudokuSolverAlgorithm::resume() {
+    if (!suspended)
+        return solve() ? 1 : 0;
+
+    const unsigned long found = search(suspension.limit, suspension.record && (progressEnabled.load() || progressListener), true);
+    stopRequested.store(false);
+    return found;
+}
+
+unsigned long SudokuSolverAlgorithm::search(unsigned long limit, bool recordProgress, bool resuming) {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+    const uint64_t all = dimension >= 64 ? ~0ULL : (1ULL << dimension) - 1;
+
+    // La ricerca lavora su una copia piatta della griglia, riportata in `grid` alla fine.
+    // Ripresa: la copia è ancora quella lasciata dalla ricerca interrotta.
+    // Valori usati per riga, colonna e blocco: il bit (v - 1) indica il valore v.
+    // Tutto lo spazio di lavoro è già nell'arena: qui non si alloca nulla.
+    if (!resuming)
+        std::copy_n(grid, cellCount, value);
+    std::fill_n(rowUsed, dimension, 0);
+    std::fill_n(colUsed, dimension, 0);
+    std::fill_n(boxUsed, dimension, 0);
+    size_t emptyCount = 0;
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        if (!given[cell])
+            empty[emptyCount++] = static_cast<unsigned short>(cell);
+        if (value[cell] == 0)
+            continue;
+        const uint64_t bit = 1ULL << (value[cell] - 1);
+        rowUsed[rowOf[cell]] |= bit;
+        colUsed[colOf[cell]] |= bit;
+        boxUsed[boxOf[cell]] |= bit;
+    }
+    const std::span<const unsigned short> emptyCells(empty, emptyCount);
+
+    // Con una soluzione in cache ogni cella prova prima il suo vecchio valore:
+    // la ricerca scende senza diramarsi fino al primo conflitto con i nuovi indizi.
+    // Se ne tiene una copia perché `solution` viene sovrascritta durante la ricerca.
+    const bool warm = resuming ? suspension.warm : hasSolution;
+    if (warm && !resuming)
+        std::copy_n(solution->data(), cellCount, phase);
+
+    // Chiave Zobrist dei valori posati, aggiornata a ogni posa e a ogni annullamento
+    const uint64_t *zobrist = tables->zobrist.data();
+    const bool useDeadStates = deadStates.enabled();
+    uint64_t key = 0;
+    for (size_t cell = 0; cell < cellCount; cell++)
+        if (value[cell])
+            key ^= zobrist[cell * dimension + value[cell] - 1];
+    if (useDeadStates)
+        deadStates.nextGeneration();
+    // Le decisioni sotto questa profondità contengono una soluzione già trovata:
+    // esaurite, non sono stati morti. Ripresa: per prudenza nessuna delle presenti lo è.
+    size_t liveDepth = resuming ? trailSize : 0;
+
+    // Spareggi casuali (xorshift64*) e riavvii: con i riavvii serve comunque un seme
+    const bool randomized = options.seed != 0 || options.restarts != RestartPolicy::None;
+    uint64_t random = (options.seed ? options.seed : 0x2545F4914F6CDD1DULL) + stats.restarts;
+    auto nextRandom = [&]() {
+        random ^= random >> 12;
+        random ^= random << 25;
+        random ^= random >> 27;
+        return random * 0x2545F4914F6CDD1DULL;
+    };
+    const bool leastConstraining = options.valueOrder == ValueOrder::LeastConstraining;
+    auto restartBudget = [&](uint64_t run) -> uint64_t {
+        switch (options.restarts) {
+        case RestartPolicy::Luby:
+            return options.restartBase * lubyTerm(run);
+        case RestartPolicy::Geometric:
+            return static_cast<uint64_t>(static_cast<double>(options.restartBase) * std::pow(options.restartGrowth, static_cast<double>(run)));
+        case RestartPolicy::None:
+            break;
+        }
+        return 0;
+    };
+    uint64_t budget = restartBudget(stats.restarts);
+    uint64_t runStart = stats.decisions;
+
+    // Celle riempite (decisioni e valori forzati), per disfarle nell'ordine inverso
+    if (!resuming) {
+        placedCount = 0;
+        trailSize = 0;
+        stats = {};
+        std::fill_n(eliminated, cellCount, 0);
+        eliminationCount = 0;
+    }
+    const bool pruning = options.propagation != PropagationLevel::Singles;
+    suspended = false;
+    enumerating = false;
+    const auto started = std::chrono::steady_clock::now();
+
+    // Traccia: ogni evento è qualche byte in un blocco in memoria, il file lo scrive un altro thread
+    SearchTraceWriter *const trace = traceWriter.get();
+    if (trace) {
+        trace->event(TraceEvent::Begin, resuming);
+        trace->field(dimension);
+        trace->field(trailSize);
+    }
+    auto tracePropagation = [&](size_t placedBefore, bool ok, bool dead) {
+        const TraceOutcome outcome = !ok ? TraceOutcome::Conflict : dead ? TraceOutcome::DeadState : TraceOutcome::Consistent;
+        trace->event(TraceEvent::Propagation, (placedCount - placedBefore) << 2 | static_cast<uint8_t>(outcome));
+    };
+
+    // I passi si pubblicano a blocchi: un lock ogni `progressBatch` passi, non ogni passo
+    size_t pendingCount = 0;
+
+    auto candidates = [&](unsigned short cell) {
+        return all & ~(rowUsed[rowOf[cell]] | colUsed[colOf[cell]] | boxUsed[boxOf[cell]] | eliminated[cell]);
+    };
+    auto place = [&](unsigned short cell, unsigned short v) {
+        const uint64_t bit = 1ULL << (v - 1);
+        value[cell] = v;
+        key ^= zobrist[static_cast<size_t>(cell) * dimension + v - 1];
+        rowUsed[rowOf[cell]] |= bit;
+        colUsed[colOf[cell]] |= bit;
+        boxUsed[boxOf[cell]] |= bit;
+        placed[placedCount++] = cell;
+        stats.placements++;
+
+        if (recordProgress) {
+            pending[pendingCount++] = {rowOf[cell], colOf[cell], v};
+            if (pendingCount == progressBatch)
+                pendingCount = flushProgress(pendingCount);
+        }
+    };
+    auto undoTo = [&](size_t mark) {
+        while (placedCount > mark) {
+            const unsigned short cell = placed[--placedCount];
+            const uint64_t bit = 1ULL << (value[cell] - 1);
+            key ^= zobrist[static_cast<size_t>(cell) * dimension + value[cell] - 1];
+            value[cell] = 0;
+            rowUsed[rowOf[cell]] &= ~bit;
+            colUsed[colOf[cell]] &= ~bit;
+            boxUsed[boxOf[cell]] &= ~bit;
+
+            if (recordProgress) {
+                pending[pendingCount++] = {rowOf[cell], colOf[cell], 0};
+                if (pendingCount == progressBatch)
+                    pendingCount = flushProgress(pendingCount);
+            }
+        }
+    };
+    auto undoEliminations = [&](size_t mark) {
+        while (eliminationCount > mark) {
+            const Elimination &removed = eliminations[--eliminationCount];
+            eliminated[removed.cell] &= ~(1ULL << removed.bit);
+        }
+    };
+
+    // Riempie i singoli nudi e nascosti finché ce ne sono; false se si arriva a una contraddizione.
+    // I singoli nascosti usano i candidati letti nel giro: possono essere vecchi (più larghi),
+    // quindi ogni posa viene ricontrollata e ciò che sfugge si trova al giro dopo.
+    auto propagate = [&]() {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+
+            for (unsigned short cell : emptyCells) {
+                if (value[cell])
+                    continue;
+                cand[cell] = candidates(cell);
+                if (cand[cell] == 0)
+                    return false;
+                if (std::has_single_bit(cand[cell])) {
+                    place(cell, static_cast<unsigned short>(std::countr_zero(cand[cell]) + 1));
+                    changed = true;
+                }
+            }
+
+            for (size_t u = 0; u < 3 * static_cast<size_t>(dimension); u++) {
+                const unsigned short *unit = &units[u * dimension];
+                uint64_t once = 0, more = 0, used = 0;
+                for (unsigned short k = 0; k < dimension; k++) {
+                    const unsigned short cell = unit[k];
+                    if (value[cell]) {
+                        used |= 1ULL << (value[cell] - 1);
+                        continue;
+                    }
+                    more |= once & cand[cell];
+                    once |= cand[cell];
+                }
+
+                // Un valore che non entra in nessuna cella dell'unità
+                if ((once | used) != all)
+                    return false;
+
+                for (uint64_t singles = once & ~more & ~used; singles; singles &= singles - 1) {
+                    const uint64_t bit = singles & (~singles + 1);
+                    for (unsigned short k = 0; k < dimension; k++) {
+                        const unsigned short cell = unit[k];
+                        if (value[cell] == 0 && (cand[cell] & bit)) {
+                            if (!(candidates(cell) & bit))
+                                return false;
+                            place(cell, static_cast<unsigned short>(std::countr_zero(bit) + 1));
+                            changed = true;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            // Fermi i singoli, le deduzioni del livello scelto; se tolgono candidati si ricomincia
+            if (!changed && pruning && !pruneCandidates(options.propagation, changed))
+                return false;
+        }
         return true;
+    };
+
+    // Valore da provare per una decisione su una cella: il meno vincolante (quello che
+    // toglie meno candidati ai vicini) e, a parità, il più basso o uno a caso
+    auto chooseValue = [&](unsigned short cell, uint64_t remaining) {
+        uint64_t best = remaining & (~remaining + 1);
+        if (std::has_single_bit(remaining) || (!leastConstraining && !randomized))
+            return best;
+
+        uint64_t bestScore = ~0ULL;
+        const size_t cellUnits[3] = {rowOf[cell], dimension + static_cast<size_t>(colOf[cell]), 2 * static_cast<size_t>(dimension) + boxOf[cell]};
+        for (uint64_t rest = remaining; rest; rest &= rest - 1) {
+            const uint64_t bit = rest & (~rest + 1);
+            uint64_t score = 0;
+            if (leastConstraining)
+                for (const size_t u : cellUnits)
+                    for (unsigned short k = 0; k < dimension; k++) {
+                        const unsigned short peer = units[u * dimension + k];
+                        if (peer != cell && value[peer] == 0 && (candidates(peer) & bit))
+                            score++;
+                    }
+            score = (score << 32) | (randomized ? nextRandom() >> 32 : 0);
+            if (score < bestScore) {
+                best = bit;
+                bestScore = score;
+            }
+        }
+        return best;
+    };
+
+    // Prossima alternativa dell'ultima decisione; finite quelle si torna alla precedente
+    auto nextAlternative = [&]() {
+        bool ok = false;
+        while (!ok && trailSize > 0 && !stopRequested.load(std::memory_order_relaxed)) {
+            Frame &frame = trail[trailSize - 1];
+            undoTo(frame.mark);
+            undoEliminations(frame.eliminationMark);
+            if (frame.remaining == 0) {
+                // Alternative finite senza soluzioni: la griglia di partenza è morta
+                if (useDeadStates && trailSize > liveDepth)
+                    deadStates.insert(key, static_cast<unsigned int>(emptyCount - placedCount));
+                --trailSize;
+                if (trace)
+                    trace->event(TraceEvent::Backtrack, 1);
+                liveDepth = std::min(liveDepth, trailSize);
+                continue;
+            }
+
+            uint64_t bit = frame.remaining & (~frame.remaining + 1);
+            if (frame.value) {
+                // Decisione su un valore: si prova la prossima posizione nell'unità
+                frame.remaining &= ~bit;
+                place(units[frame.cell * dimension + std::countr_zero(bit)], frame.value);
+            } else {
+                if (warm && phase[frame.cell] && (frame.remaining & (1ULL << (phase[frame.cell] - 1))))
+                    bit = 1ULL << (phase[frame.cell] - 1);
+                else
+                    bit = chooseValue(frame.cell, frame.remaining);
+                frame.remaining &= ~bit;
+                place(frame.cell, static_cast<unsigned short>(std::countr_zero(bit) + 1));
+            }
+            const size_t placedBefore = placedCount;
+            if (trace) {
+                const unsigned short cell = placed[placedCount - 1];
+                trace->event(TraceEvent::Try, cell);
+                trace->field(value[cell]);
+            }
+            ok = propagate();
+            bool dead = false;
+            if (!ok) {
+                stats.conflicts++;
+            } else if (useDeadStates && deadStates.contains(key)) {
+                stats.deadStateHits++;
+                ok = false;
+                dead = true;
+            }
+            if (trace)
+                tracePropagation(placedBefore, ok || dead, dead);
+        }
+        return ok;
+    };
+
+    unsigned long found = 0;
+    bool consistent = false;
+    bool paused = false;
+    if (!resuming) {
+        const size_t placedBefore = placedCount;
+        consistent = propagate();
+        bool dead = false;
+        if (!consistent) {
+            stats.conflicts++;
+        } else if (useDeadStates && deadStates.contains(key)) {
+            stats.deadStateHits++;
+            consistent = false;
+            dead = true;
+        }
+        if (trace)
+            tracePropagation(placedBefore, consistent || dead, dead);
+    } else {
+        found = suspension.found;
+        consistent = suspension.consistent;
+
+        // Chi guarda i passi vede prima le celle già riempite dalla ricerca interrotta
+        if (recordProgress) {
+            for (size_t i = 0; i < placedCount; i++) {
+                const unsigned short cell = placed[i];
+                pending[pendingCount++] = {rowOf[cell], colOf[cell], value[cell]};
+                if (pendingCount == progressBatch)
+                    pendingCount = flushProgress(pendingCount);
+            }
+        }
+        if (!consistent)
+            consistent = nextAlternative();
     }
 
-    // Se siamo alla fine di una riga, passa alla successiva
-    if (column == dimension) {
-        return solveRecursive(row + 1, 0);
+    // Checkpoint periodici: si guarda l'orologio ogni 64 giri, non a ogni decisione
+    auto nextCheckpoint = started + checkpointInterval;
+    unsigned int sinceClock = 0;
+
+    while (consistent && !stopRequested.load(std::memory_order_relaxed)) {
+        // In cima al giro nessuna decisione è a metà: lo stato si può salvare così com'è
+        if (checkpointWriter && ++sinceClock == 64) {
+            sinceClock = 0;
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= nextCheckpoint) {
+                writeCheckpoint(Suspension{limit, found, true, warm, recordProgress}, now - started);
+                nextCheckpoint = now + checkpointInterval;
+            }
+        }
+
+        // Riavvio: la corsa ha finito il suo budget senza soluzioni; si torna agli indizi
+        // senza registrare stati morti (le decisioni abbandonate non sono esaurite)
+        if (budget && found == 0 && stats.decisions - runStart >= budget) {
+            undoTo(0);
+            undoEliminations(0);
+            if (trace && trailSize > 0)
+                trace->event(TraceEvent::Backtrack, trailSize);
+            trailSize = 0;
+            liveDepth = 0;
+            stats.restarts++;
+            budget = restartBudget(stats.restarts);
+            runStart = stats.decisions;
+            consistent = propagate();
+            bool dead = false;
+            if (consistent && useDeadStates && deadStates.contains(key)) {
+                stats.deadStateHits++;
+                consistent = false;
+                dead = true;
+            }
+            if (trace)
+                tracePropagation(0, consistent || dead, dead);
+            if (!consistent)
+                break;
+        }
+
+        // Cella con meno candidati (MRV): i rami si tagliano il prima possibile.
+        // Con gli spareggi casuali il giro parte da una cella a caso.
+        int best = -1;
+        int bestCount = 65;
+        const size_t scanStart = randomized && emptyCount ? nextRandom() % emptyCount : 0;
+        for (size_t i = 0; i < emptyCount; i++) {
+            const unsigned short cell = empty[scanStart + i < emptyCount ? scanStart + i : scanStart + i - emptyCount];
+            if (value[cell])
+                continue;
+            const int count = std::popcount(candidates(cell));
+            if (count < bestCount) {
+                best = cell;
+                bestCount = count;
+                if (count <= 2)
+                    break;
+            }
+        }
+
+        // Senza celle a due candidati si cerca un valore con due sole posizioni in un'unità:
+        // diramarsi sulle posizioni taglia quanto diramarsi su una cella a due valori
+        int branchUnit = -1;
+        uint64_t branchBit = 0;
+        if (best >= 0 && bestCount > 2) {
+            for (size_t u = 0; u < 3 * static_cast<size_t>(dimension) && branchUnit < 0; u++) {
+                const unsigned short *unit = &units[u * dimension];
+                uint64_t once = 0, twice = 0, more = 0;
+                for (unsigned short k = 0; k < dimension; k++) {
+                    if (value[unit[k]])
+                        continue;
+                    const uint64_t c = candidates(unit[k]);
+                    more |= twice & c;
+                    twice |= once & c;
+                    once |= c;
+                }
+                const uint64_t pairs = twice & ~more;
+                if (pairs) {
+                    branchUnit = static_cast<int>(u);
+                    branchBit = pairs & (~pairs + 1);
+                }
+            }
+        }
+
+        if (best < 0) {
+            if (trace)
+                trace->event(TraceEvent::Solution, 0);
+            // Soluzione completa: la prima viene salvata
+            if (found++ == 0) {
+                std::copy_n(value, cellCount, writableSolution());
+                hasSolution = true;
+            }
+            liveDepth = trailSize;
+            // Chi enumera può fermarsi qui: alla ripresa si passa alla soluzione successiva
+            if (solutionVisitor && !(*solutionVisitor)(std::span<const unsigned short>(value, cellCount))) {
+                paused = true;
+                consistent = false;
+                break;
+            }
+            if (found >= limit)
+                break;
+            // Per contarne altre si prosegue come se l'ultima decisione fosse fallita
+        } else if (branchUnit >= 0) {
+            uint64_t positions = 0;
+            for (unsigned short k = 0; k < dimension; k++) {
+                const unsigned short cell = units[branchUnit * dimension + k];
+                if (value[cell] == 0 && (candidates(cell) & branchBit))
+                    positions |= 1ULL << k;
+            }
+            trail[trailSize++] = {static_cast<unsigned short>(branchUnit), positions, static_cast<unsigned int>(placedCount),
+                                  static_cast<unsigned short>(std::countr_zero(branchBit) + 1),
+                                  static_cast<unsigned int>(eliminationCount)};
+            stats.decisions++;
+            if (trace) {
+                trace->event(TraceEvent::UnitDecision, static_cast<uint64_t>(branchUnit));
+                trace->field(std::countr_zero(branchBit) + 1);
+                trace->field(std::popcount(positions));
+            }
+        } else {
+            const auto cell = static_cast<unsigned short>(best);
+            trail[trailSize++] = {cell, candidates(cell), static_cast<unsigned int>(placedCount), 0,
+                                  static_cast<unsigned int>(eliminationCount)};
+            stats.decisions++;
+            if (trace) {
+                trace->event(TraceEvent::Decision, cell);
+                trace->field(std::popcount(trail[trailSize - 1].remaining));
+            }
+        }
+
+        consistent = nextAlternative();
+    }
+
+    if (recordProgress)
+        flushProgress(pendingCount);
+
+    // Fermata a metà: lo spazio di lavoro resta com'è, per riprendere da qui
+    const bool interrupted = paused || (stopRequested.load(std::memory_order_relaxed) && found < limit
+                                        && (consistent || trailSize > 0));
+
+    // La griglia mostra la prima soluzione trovata, altrimenti i soli indizi
+    if (found > 0) {
+        std::copy_n(solution->data(), cellCount, grid);
+    } else {
+        resetToClues();
+    }
+    solvedInGrid = found > 0;
+
+    if (interrupted) {
+        suspended = true;
+        suspension = {limit, found, consistent, warm, recordProgress};
+    }
+    const auto running = std::chrono::steady_clock::now() - started;
+    stats.elapsed += running;
+    if (trace) {
+        trace->event(TraceEvent::End, interrupted);
+        trace->field(found);
+        trace->field(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(running).count()));
+        trace->handOff();
+    }
+
+    // L'ultimo checkpoint è lo stato finale: risolto, oppure fermo e da riprendere
+    if (checkpointWriter)
+        writeCheckpoint(suspended ? suspension : Suspension{}, std::chrono::nanoseconds(0), suspended);
+    return found;
+}
+
+bool SudokuSolverAlgorithm::pruneCandidates(PropagationLevel level, bool &changed) {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+    const uint64_t all = dimension >= 64 ? ~0ULL : (1ULL << dimension) - 1;
+
+    // Candidati aggiornati di ogni cella; 0 per le celle piene
+    for (size_t cell = 0; cell < cellCount; cell++)
+        cand[cell] = value[cell] ? 0
+                   : all & ~(rowUsed[rowOf[cell]] | colUsed[colOf[cell]] | boxUsed[boxOf[cell]] | eliminated[cell]);
+
+    // Toglie candidati a una cella e li annota per disfarli; false se la cella resta senza
+    auto remove = [&](unsigned short cell, uint64_t bits) {
+        bits &= cand[cell];
+        if (!bits)
+            return true;
+        cand[cell] &= ~bits;
+        eliminated[cell] |= bits;
+        for (; bits; bits &= bits - 1)
+            eliminations[eliminationCount++] = {cell, static_cast<unsigned short>(std::countr_zero(bits))};
+        changed = true;
+        return cand[cell] != 0;
+    };
+
+    if (!eliminateLockedCandidates(cand, changed, eliminated, eliminations, &eliminationCount))
+        return false;
+    if (level == PropagationLevel::LockedCandidates)
+        return true;
+
+    // Coppie e terne nude: k celle con k candidati in tutto li tolgono al resto dell'unità.
+    // Coppie e terne nascoste: k valori che stanno solo in k celle lasciano a quelle solo loro.
+    unsigned short pick[64];
+    uint64_t where[64];
+    for (size_t u = 0; u < 3 * static_cast<size_t>(dimension); u++) {
+        const unsigned short *unit = &units[u * dimension];
+
+        int count = 0;
+        for (unsigned short k = 0; k < dimension; k++) {
+            const int n = std::popcount(cand[unit[k]]);
+            if (n == 2 || n == 3)
+                pick[count++] = k;
+        }
+        for (int a = 0; a < count; a++)
+            for (int b = a + 1; b < count; b++) {
+                const uint64_t pair = cand[unit[pick[a]]] | cand[unit[pick[b]]];
+                const int n = std::popcount(pair);
+                for (int c = (n == 2 ? count : b + 1); c <= count && n <= 3; c++) {
+                    const uint64_t subset = c < count ? pair | cand[unit[pick[c]]] : pair;
+                    if (std::popcount(subset) != (c < count ? 3 : 2))
+                        continue;
+                    for (unsigned short k = 0; k < dimension; k++)
+                        if (k != pick[a] && k != pick[b] && (c == count || k != pick[c]) && !remove(unit[k], subset))
+                            return false;
+                }
+            }
+
+        // Posizioni nell'unità di ogni valore (bit k per la k-esima cella)
+        std::fill_n(where, dimension, 0);
+        for (unsigned short k = 0; k < dimension; k++)
+            for (uint64_t bits = cand[unit[k]]; bits; bits &= bits - 1)
+                where[std::countr_zero(bits)] |= 1ULL << k;
+        count = 0;
+        for (unsigned short v = 0; v < dimension; v++) {
+            const int n = std::popcount(where[v]);
+            if (n == 2 || n == 3)
+                pick[count++] = v;
+        }
+        for (int a = 0; a < count; a++)
+            for (int b = a + 1; b < count; b++) {
+                const uint64_t pair = where[pick[a]] | where[pick[b]];
+                const int n = std::popcount(pair);
+                for (int c = (n == 2 ? count : b + 1); c <= count && n <= 3; c++) {
+                    const uint64_t cells = c < count ? pair | where[pick[c]] : pair;
+                    if (std::popcount(cells) != (c < count ? 3 : 2))
+                        continue;
+                    uint64_t keep = (1ULL << pick[a]) | (1ULL << pick[b]);
+                    if (c < count)
+                        keep |= 1ULL << pick[c];
+                    for (uint64_t rest = cells; rest; rest &= rest - 1)
+                        if (!remove(unit[std::countr_zero(rest)], ~keep))
+                            return false;
+                }
+            }
     }
+    if (level == PropagationLevel::Subsets)
+        return true;
+
+    // Pesci: se un valore sta, in k righe, solo in k colonne (X-wing per 2, Swordfish per 3),
+    // esce dalle altre righe di quelle colonne; lo stesso scambiando righe e colonne
+    for (unsigned short v = 0; v < dimension; v++) {
+        const uint64_t bit = 1ULL << v;
+        for (int columns = 0; columns < 2; columns++) {
+            const size_t baseUnits = columns ? dimension : 0;
+            const size_t coverUnits = columns ? 0 : dimension;
+
+            int count = 0;
+            for (unsigned short line = 0; line < dimension; line++) {
+                uint64_t positions = 0;
+                for (unsigned short k = 0; k < dimension; k++)
+                    if (cand[units[(baseUnits + line) * dimension + k]] & bit)
+                        positions |= 1ULL << k;
+                where[line] = positions;
+                const int n = std::popcount(positions);
+                if (n == 2 || n == 3)
+                    pick[count++] = line;
+            }
 
-    // Se la cella è già piena, passa alla prossima
-    if (grid[row][column] != 0) {
-        return solveRecursive(row, column + 1);
+            for (int a = 0; a < count; a++)
+                for (int b = a + 1; b < count; b++) {
+                    const uint64_t pair = where[pick[a]] | where[pick[b]];
+                    const int n = std::popcount(pair);
+                    for (int c = (n == 2 ? count : b + 1); c <= count && n <= 3; c++) {
+                        const uint64_t covers = c < count ? pair | where[pick[c]] : pair;
+                        if (std::popcount(covers) != (c < count ? 3 : 2))
+                            continue;
+                        for (uint64_t rest = covers; rest; rest &= rest - 1) {
+                            const size_t cover = coverUnits + std::countr_zero(rest);
+                            // La k-esima cella della colonna (riga) sta sulla riga (colonna) k
+                            for (unsigned short k = 0; k < dimension; k++)
+                                if (k != pick[a] && k != pick[b] && (c == count || k != pick[c])
+                                    && !remove(units[cover * dimension + k], bit))
+                                    return false;
+                        }
+                    }
+                }
+        }
     }
+    return true;
+}
+
+unsigned long SudokuSolverAlgorithm::searchSat(unsigned long limit) {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+    const uint64_t all = dimension >= 64 ? ~0ULL : (1ULL << dimension) - 1;
+    const auto started = std::chrono::steady_clock::now();
+    suspended = false;
+    stats = {};
 
-    // Prova tutti i numeri possibili
-    for (unsigned short num = 1; num <= dimension; num++) {
-        if (isSafe(row, column, num)) {
-            grid[row][column] = num;
+    // Valori esclusi dagli indizi: quei candidati non diventano nemmeno variabili
+    std::fill_n(rowUsed, dimension, 0);
+    std::fill_n(colUsed, dimension, 0);
+    std::fill_n(boxUsed, dimension, 0);
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        if (grid[cell] == 0)
+            continue;
+        const uint64_t bit = 1ULL << (grid[cell] - 1);
+        rowUsed[rowOf[cell]] |= bit;
+        colUsed[colOf[cell]] |= bit;
+        boxUsed[boxOf[cell]] |= bit;
+    }
 
-            pushCoord(row, column);
+    SatSolver sat;
+    bool consistent = true;
+    std::vector<SatSolver::Lit> clause;
+    auto add = [&](std::initializer_list<SatSolver::Lit> literals) {
+        consistent = sat.addClause(std::span<const SatSolver::Lit>(literals.begin(), literals.size())) && consistent;
+    };
 
-            if (solveRecursive(row, column + 1)) {
-                return true;
+    // variable[cell * dimension + v - 1]: la cella vale v; -1 se v non è candidato
+    std::vector<int> variable(cellCount * dimension, -1);
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        int *vars = &variable[cell * dimension];
+        if (given[cell]) {
+            vars[grid[cell] - 1] = sat.newVar();
+            add({SatSolver::pos(vars[grid[cell] - 1])});
+            continue;
+        }
+        uint64_t mask = all & ~(rowUsed[rowOf[cell]] | colUsed[colOf[cell]] | boxUsed[boxOf[cell]]);
+        for (; mask; mask &= mask - 1) {
+            const int v = std::countr_zero(mask);
+            vars[v] = sat.newVar();
+            // Avvio a caldo: ogni variabile parte dal valore della soluzione in cache
+            if (hasSolution && (*solution)[cell] == v + 1)
+                sat.setPolarity(vars[v], true);
+        }
+    }
+
+    // Esattamente una variabile vera nel gruppo; l'"al più una" oltre quattro variabili
+    // usa un contatore sequenziale: k - 1 variabili ausiliarie e 3k - 4 clausole binarie
+    std::vector<int> group;
+    auto exactlyOne = [&]() {
+        clause.clear();
+        for (const int var : group)
+            clause.push_back(SatSolver::pos(var));
+        consistent = sat.addClause(clause) && consistent;
+
+        if (group.size() <= 4) {
+            for (size_t i = 0; i < group.size(); i++)
+                for (size_t j = i + 1; j < group.size(); j++)
+                    add({SatSolver::neg(group[i]), SatSolver::neg(group[j])});
+            return;
+        }
+        int previous = -1;
+        for (size_t i = 0; i < group.size(); i++) {
+            const int x = group[i];
+            if (previous >= 0)
+                add({SatSolver::neg(x), SatSolver::neg(previous)});
+            if (i + 1 == group.size())
+                break;
+            const int counter = sat.newVar();
+            add({SatSolver::neg(x), SatSolver::pos(counter)});
+            if (previous >= 0)
+                add({SatSolver::neg(previous), SatSolver::pos(counter)});
+            previous = counter;
+        }
+    };
+
+    for (size_t cell = 0; cell < cellCount && consistent; cell++) {
+        group.clear();
+        for (unsigned short v = 0; v < dimension; v++)
+            if (variable[cell * dimension + v] >= 0)
+                group.push_back(variable[cell * dimension + v]);
+        exactlyOne();
+    }
+    for (unsigned short u = 0; u < 3 * dimension && consistent; u++) {
+        for (unsigned short v = 0; v < dimension; v++) {
+            group.clear();
+            for (unsigned short k = 0; k < dimension; k++) {
+                const int var = variable[static_cast<size_t>(unitCell(u, k)) * dimension + v];
+                if (var >= 0)
+                    group.push_back(var);
             }
+            exactlyOne();
+        }
+    }
 
-            // Backtrack
-            grid[row][column] = 0;
+    unsigned long found = 0;
+    while (consistent && found < limit && sat.solve(&stopRequested) == SatSolver::Result::Satisfiable) {
+        // Dal modello alla griglia: il valore di ogni cella è la sua variabile vera
+        for (size_t cell = 0; cell < cellCount; cell++)
+            for (unsigned short v = 0; v < dimension; v++) {
+                const int var = variable[cell * dimension + v];
+                if (var >= 0 && sat.modelValue(var))
+                    value[cell] = v + 1;
+            }
+        if (found++ == 0) {
+            std::copy_n(value, cellCount, writableSolution());
+            hasSolution = true;
         }
+        if (found == limit)
+            break;
+
+        // La soluzione trovata si esclude: almeno una cella non indizio deve cambiare
+        clause.clear();
+        for (size_t cell = 0; cell < cellCount; cell++)
+            if (!given[cell])
+                clause.push_back(SatSolver::neg(variable[cell * dimension + value[cell] - 1]));
+        consistent = sat.addClause(clause);
     }
 
-    return false;
+    if (found > 0) {
+        std::copy_n(solution->data(), cellCount, grid);
+    } else {
+        resetToClues();
+    }
+    solvedInGrid = found > 0;
+
+    const SatSolver::Statistics &counters = sat.statistics();
+    stats.decisions = counters.decisions;
+    stats.conflicts = counters.conflicts;
+    stats.placements = counters.propagations;
+    stats.elapsed = std::chrono::steady_clock::now() - started;
+
+    if (checkpointWriter)
+        writeCheckpoint(Suspension{}, std::chrono::nanoseconds(0), false);
+    return found;
+}
+
+void SudokuSolverAlgorithm::writeCheckpoint(const Suspension &search, std::chrono::nanoseconds running, bool inSearch) {
+    SearchStatistics statistics = stats;
+    statistics.elapsed += running;
+
+    checkpointBuffer.clear();
+    writeState(checkpointBuffer, inSearch ? &search : nullptr, statistics);
+    checkpointWriter->submit(checkpointBuffer);
+}
+
+void SudokuSolverAlgorithm::setCheckpointing(const std::string &path, std::chrono::milliseconds interval) {
+    checkpointWriter.reset();
+    checkpointInterval = interval;
+    if (!path.empty())
+        checkpointWriter = std::make_unique<CheckpointWriter>(path);
+}
+
+std::error_code SudokuSolverAlgorithm::checkpointError() const {
+    return checkpointWriter ? checkpointWriter->error() : std::error_code();
+}
+
+bool SudokuSolverAlgorithm::loadCheckpoint(const std::string &path) {
+    // Un checkpoint ancora in scrittura sullo stesso file va prima completato
+    if (checkpointWriter && checkpointWriter->path() == path)
+        checkpointWriter->flush();
+
+    std::vector<uint8_t> data;
+    return CheckpointWriter::read(path, data) && deserialize(data);
+}
+
+unsigned long SudokuSolverAlgorithm::resume(const std::string &checkpointPath) {
+    if (!loadCheckpoint(checkpointPath))
+        return 0;
+    return resume();
+}
+
+bool SudokuSolverAlgorithm::setTracing(const std::string &path) {
+    traceWriter.reset();
+    if (path.empty())
+        return true;
+
+    traceWriter = std::make_unique<SearchTraceWriter>(path);
+    if (!traceWriter->good()) {
+        traceWriter.reset();
+        return false;
+    }
+    return true;
+}
+
+void SudokuSolverAlgorithm::setSearchOptions(const SearchOptions &searchOptions) {
+    options = searchOptions;
+}
+
+void SudokuSolverAlgorithm::setDeadStateTable(size_t bytes) {
+    deadStates.setBudget(bytes);
+}
+
+SudokuSolverAlgorithm::SearchStatistics SudokuSolverAlgorithm::statistics() const {
+    return stats;
+}
+
+char SudokuSolverAlgorithm::symbolFor(unsigned short value) {
+    return value < sizeof(alphabet) - 1 ? alphabet[value] : '?';
+}
+
+unsigned short SudokuSolverAlgorithm::valueFor(char symbol, unsigned short dimension) {
+    if (symbol >= 'a' && symbol <= 'z')
+        symbol = static_cast<char>(symbol - 'a' + 'A');
+
+    for (unsigned short value = 1; value <= dimension && value < sizeof(alphabet) - 1; value++)
+        if (alphabet[value] == symbol)
+            return value;
+    return 0;
+}
+
+void SudokuSolverAlgorithm::resetToClues() {
+    for (unsigned short i = 0; i < dimension; i++)
+        for (unsigned short j = 0; j < dimension; j++)
+            if (!given[i * dimension + j])
+                grid[i * dimension + j] = 0;
+    solvedInGrid = false;
+    suspended = false;
+}
+
+bool SudokuSolverAlgorithm::solutionFitsClues() const {
+    if (!hasSolution)
+        return false;
+
+    for (unsigned short i = 0; i < dimension; i++)
+        for (unsigned short j = 0; j < dimension; j++)
+            if (given[i * dimension + j] && (*solution)[i * dimension + j] != grid[i * dimension + j])
+                return false;
+
+    return true;
+}
+
+SudokuSolverAlgorithm::Hint SudokuSolverAlgorithm::findHint(std::chrono::microseconds budget) const {
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+    const uint64_t all = dimension >= 64 ? ~0ULL : (1ULL << dimension) - 1;
+
+    // Valori usati per riga, colonna e blocco: il bit (v - 1) indica il valore v
+    std::vector<uint64_t> rowUsed(dimension, 0), colUsed(dimension, 0), boxUsed(dimension, 0);
+    for (unsigned short i = 0; i < dimension; i++)
+        for (unsigned short j = 0; j < dimension; j++)
+            if (grid[i * dimension + j]) {
+                const uint64_t bit = 1ULL << (grid[i * dimension + j] - 1);
+                rowUsed[i] |= bit;
+                colUsed[j] |= bit;
+                boxUsed[(i / blockSize) * blockSize + j / blockSize] |= bit;
+            }
+
+    std::vector<uint64_t> cand(cellCount, 0);
+    for (unsigned short i = 0; i < dimension; i++)
+        for (unsigned short j = 0; j < dimension; j++)
+            if (!grid[i * dimension + j])
+                cand[i * dimension + j] = all & ~(rowUsed[i] | colUsed[j] | boxUsed[(i / blockSize) * blockSize + j / blockSize]);
+
+    HintTechnique found = HintTechnique::NakedSingle;
+    while (true) {
+        // Singolo nudo: una sola possibilità nella cella
+        for (size_t cell = 0; cell < cellCount; cell++) {
+            if (grid[cell])
+                continue;
+            if (cand[cell] == 0)
+                return {static_cast<unsigned short>(cell / dimension), static_cast<unsigned short>(cell % dimension), 0, HintTechnique::Contradiction};
+            if (std::has_single_bit(cand[cell]))
+                return {static_cast<unsigned short>(cell / dimension), static_cast<unsigned short>(cell % dimension),
+                        static_cast<unsigned short>(std::countr_zero(cand[cell]) + 1), found};
+        }
+
+        // Singolo nascosto: un valore che entra in una sola cella dell'unità
+        for (unsigned short u = 0; u < 3 * dimension; u++) {
+            uint64_t once = 0, more = 0, placed = 0;
+            for (unsigned short k = 0; k < dimension; k++) {
+                const unsigned short cell = unitCell(u, k);
+                const unsigned short v = grid[cell];
+                if (v) {
+                    placed |= 1ULL << (v - 1);
+                    continue;
+                }
+                more |= once & cand[cell];
+                once |= cand[cell];
+            }
+
+            const uint64_t singles = once & ~more & ~placed;
+            if (!singles)
+                continue;
+
+            const uint64_t bit = singles & (~singles + 1);
+            for (unsigned short k = 0; k < dimension; k++) {
+                const unsigned short cell = unitCell(u, k);
+                if (cand[cell] & bit)
+                    return {static_cast<unsigned short>(cell / dimension), static_cast<unsigned short>(cell % dimension),
+                            static_cast<unsigned short>(std::countr_zero(bit) + 1),
+                            found == HintTechnique::NakedSingle ? HintTechnique::HiddenSingle : found};
+            }
+        }
+
+        // Nessun singolo: si prova con i candidati bloccati, entro il budget.
+        // Una cella rimasta senza candidati la segnala il giro successivo.
+        bool changed = false;
+        if (std::chrono::steady_clock::now() >= deadline)
+            return {};
+        eliminateLockedCandidates(cand.data(), changed);
+        if (!changed)
+            return {};
+        found = HintTechnique::LockedCandidates;
+    }
+}
+
+std::vector<SudokuSolverAlgorithm::Hint> SudokuSolverAlgorithm::forcedPlacements() const {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+    const uint64_t all = dimension >= 64 ? ~0ULL : (1ULL << dimension) - 1;
+
+    // Si lavora su una copia: la griglia non cambia
+    std::vector<unsigned short> values(grid, grid + cellCount);
+    std::vector<uint64_t> rowUsed(dimension, 0), colUsed(dimension, 0), boxUsed(dimension, 0);
+    for (size_t cell = 0; cell < cellCount; cell++)
+        if (values[cell]) {
+            const uint64_t bit = 1ULL << (values[cell] - 1);
+            rowUsed[rowOf[cell]] |= bit;
+            colUsed[colOf[cell]] |= bit;
+            boxUsed[boxOf[cell]] |= bit;
+        }
+    std::vector<uint64_t> cand(cellCount, 0);
+    for (size_t cell = 0; cell < cellCount; cell++)
+        if (!values[cell])
+            cand[cell] = all & ~(rowUsed[rowOf[cell]] | colUsed[colOf[cell]] | boxUsed[boxOf[cell]]);
+
+    std::vector<Hint> placements;
+    auto hintAt = [&](size_t cell, unsigned short v, HintTechnique technique) {
+        return Hint{static_cast<unsigned short>(cell / dimension), static_cast<unsigned short>(cell % dimension), v, technique};
+    };
+
+    // Una posa toglie il valore dai candidati delle sole celle della sua riga, colonna e blocco
+    auto place = [&](size_t cell, unsigned short v, HintTechnique technique) {
+        const uint64_t bit = 1ULL << (v - 1);
+        values[cell] = v;
+        cand[cell] = 0;
+        for (const unsigned short u : {rowOf[cell], static_cast<unsigned short>(dimension + colOf[cell]),
+                                       static_cast<unsigned short>(2 * dimension + boxOf[cell])})
+            for (unsigned short k = 0; k < dimension; k++)
+                cand[unitCell(u, k)] &= ~bit;
+        placements.push_back(hintAt(cell, v, technique));
+    };
+
+    bool locked = false;
+    while (true) {
+        bool progress = false;
+
+        // Singoli nudi
+        for (size_t cell = 0; cell < cellCount; cell++) {
+            if (values[cell])
+                continue;
+            if (cand[cell] == 0) {
+                placements.push_back(hintAt(cell, 0, HintTechnique::Contradiction));
+                return placements;
+            }
+            if (std::has_single_bit(cand[cell])) {
+                place(cell, static_cast<unsigned short>(std::countr_zero(cand[cell]) + 1),
+                      locked ? HintTechnique::LockedCandidates : HintTechnique::NakedSingle);
+                progress = true;
+            }
+        }
+
+        // Singoli nascosti; un valore senza posto in un'unità è una contraddizione
+        for (unsigned short u = 0; u < 3 * dimension; u++) {
+            uint64_t once = 0, more = 0, placed = 0;
+            int firstEmpty = -1;
+            for (unsigned short k = 0; k < dimension; k++) {
+                const unsigned short cell = unitCell(u, k);
+                if (values[cell]) {
+                    placed |= 1ULL << (values[cell] - 1);
+                    continue;
+                }
+                if (firstEmpty < 0)
+                    firstEmpty = cell;
+                more |= once & cand[cell];
+                once |= cand[cell];
+            }
+            if (const uint64_t missing = all & ~placed & ~once) {
+                placements.push_back(hintAt(static_cast<size_t>(firstEmpty),
+                                            static_cast<unsigned short>(std::countr_zero(missing) + 1),
+                                            HintTechnique::Contradiction));
+                return placements;
+            }
+
+            for (uint64_t singles = once & ~more; singles; singles &= singles - 1) {
+                const uint64_t bit = singles & (~singles + 1);
+                for (unsigned short k = 0; k < dimension; k++) {
+                    const unsigned short cell = unitCell(u, k);
+                    if (cand[cell] & bit) {
+                        place(cell, static_cast<unsigned short>(std::countr_zero(bit) + 1),
+                              locked ? HintTechnique::LockedCandidates : HintTechnique::HiddenSingle);
+                        progress = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (!progress) {
+            // Una cella rimasta senza candidati la segnala il giro successivo
+            bool changed = false;
+            eliminateLockedCandidates(cand.data(), changed);
+            if (!changed)
+                break;
+            locked = true;
+        }
+    }
+    return placements;
+}
+
+bool SudokuSolverAlgorithm::eliminateLockedCandidates(uint64_t *cand, bool &changed, uint64_t *removed,
+                                                      Elimination *trail, size_t *trailSize) const {
+    // Toglie candidati a una cella, annotandoli per disfarli se richiesto; false se la cella resta senza
+    auto remove = [&](unsigned short cell, uint64_t bits) {
+        bits &= cand[cell];
+        if (!bits)
+            return true;
+        cand[cell] &= ~bits;
+        if (removed) {
+            removed[cell] |= bits;
+            for (; bits; bits &= bits - 1)
+                trail[(*trailSize)++] = {cell, static_cast<unsigned short>(std::countr_zero(bits))};
+        }
+        changed = true;
+        return cand[cell] != 0;
+    };
+
+    // Candidati bloccati. Per ogni riga (poi colonna) e ogni blocco che attraversa,
+    // l'unione dei candidati del segmento in comune.
+    // Pointing: un valore del blocco che sta in un solo segmento esce dal resto della linea.
+    // Claiming: un valore della linea che sta in un solo segmento esce dal resto del blocco.
+    uint64_t segment[64 * 8];
+    for (int columns = 0; columns < 2; columns++) {
+        const size_t lineUnits = columns ? dimension : 0;
+        for (unsigned short line = 0; line < dimension; line++)
+            for (unsigned short s = 0; s < blockSize; s++) {
+                uint64_t bits = 0;
+                for (unsigned short k = s * blockSize; k < (s + 1) * blockSize; k++)
+                    bits |= cand[units[(lineUnits + line) * dimension + k]];
+                segment[line * blockSize + s] = bits;
+            }
+
+        for (unsigned short line = 0; line < dimension; line++) {
+            const unsigned short band = line / blockSize;
+            for (unsigned short s = 0; s < blockSize; s++) {
+                uint64_t inBox = 0, inLine = 0;
+                for (unsigned short other = 0; other < blockSize; other++) {
+                    if (other != line % blockSize)
+                        inBox |= segment[(band * blockSize + other) * blockSize + s];
+                    if (other != s)
+                        inLine |= segment[line * blockSize + other];
+                }
+                const uint64_t pointing = segment[line * blockSize + s] & ~inBox;
+                const uint64_t claiming = segment[line * blockSize + s] & ~inLine;
+
+                if (pointing)
+                    for (unsigned short k = 0; k < dimension; k++)
+                        if (k / blockSize != s && !remove(units[(lineUnits + line) * dimension + k], pointing))
+                            return false;
+                if (claiming) {
+                    const unsigned short box = columns ? s * blockSize + band : band * blockSize + s;
+                    for (unsigned short k = 0; k < dimension; k++) {
+                        const unsigned short cell = units[(2 * static_cast<size_t>(dimension) + box) * dimension + k];
+                        if ((columns ? colOf[cell] : rowOf[cell]) != line && !remove(cell, claiming))
+                            return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+unsigned short SudokuSolverAlgorithm::unitCell(unsigned short u, unsigned short k) const {
+    return units[static_cast<size_t>(u) * dimension + k];
 }
 
 void SudokuSolverAlgorithm::printGrid() const {
     for (unsigned short i = 0; i < dimension; i++) {
         for (unsigned short j = 0; j < dimension; j++) {
-            std::cout << grid[i][j] << " ";
+            std::cout << grid[i * dimension + j] << " ";
         }
         std::cout << std::endl;
     }
 }
 
 void SudokuSolverAlgorithm::clean(const unsigned short & row, const unsigned short & col) {
-    if (row < dimension && col < dimension)
-        grid[row][col] = 0;
+    if (row < dimension && col < dimension) {
+        if (solvedInGrid)
+            resetToClues();
+        grid[row * dimension + col] = 0;
+        given[row * dimension + col] = 0;
+        suspended = false;
+    }
 }
 
 void SudokuSolverAlgorithm::clean() {
-    for (unsigned short i = 0; i < dimension; i++) {
-        for (unsigned short j = 0; j<dimension; j++)
-            grid[i][j] = 0;
-    }
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+    std::fill_n(grid, cellCount, 0);
+    std::fill_n(given, cellCount, 0);
+    solvedInGrid = false;
+
+    // Nuova partita: la soluzione in cache non vale più
+    hasSolution = false;
+    trailSize = 0;
+    suspended = false;
+}
+
+bool SudokuSolverAlgorithm::isGiven(const unsigned short & row, const unsigned short & column) const {
+    return row < dimension && column < dimension && given[row * dimension + column];
+}
+
+bool SudokuSolverAlgorithm::hasCachedSolution() const {
+    return hasSolution;
 }
 
 unsigned short SudokuSolverAlgorithm::get(const unsigned short & row, const unsigned short & column) const {
     if (row < dimension && column < dimension)
-        return grid[row][column];
+        return grid[row * dimension + column];
     return 0;
 }
 
 bool SudokuSolverAlgorithm::checkAll() const {
-    for (unsigned short i = 0; i < dimension; i++)
-        for (unsigned short j = 0; j < dimension; j++)
-            if (grid[i][j])
-                if (! isSafe(i, j, grid[i][j])) {
-                    printf("Errore alla riga %d colonna %d valore %d", i, j, grid[i][j]);
-                    return false;
-                }
-
+    // Una sola passata: un valore già visto nella riga, colonna o blocco è un errore
+    uint64_t rows[64] = {}, cols[64] = {}, boxes[64] = {};
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        if (!grid[cell])
+            continue;
+        const uint64_t bit = 1ULL << (grid[cell] - 1);
+        if ((rows[rowOf[cell]] | cols[colOf[cell]] | boxes[boxOf[cell]]) & bit)
+            return false;
+        rows[rowOf[cell]] |= bit;
+        cols[colOf[cell]] |= bit;
+        boxes[boxOf[cell]] |= bit;
+    }
     return true;
 }
 
+std::vector<SudokuSolverAlgorithm::Conflict> SudokuSolverAlgorithm::validate() const {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+
+    // Per ogni unità la prima cella di ogni valore: chi lo ripete segna entrambe.
+    // Un bit per cella: 64 parole bastano fino a 64x64, sullo stack, e controllare non alloca.
+    uint64_t conflicting[64] = {};
+    int firstCell[64];
+    for (unsigned short u = 0; u < 3 * dimension; u++) {
+        std::fill_n(firstCell, dimension, -1);
+        for (unsigned short k = 0; k < dimension; k++) {
+            const unsigned short cell = unitCell(u, k);
+            const unsigned short v = grid[cell];
+            if (!v)
+                continue;
+            if (firstCell[v - 1] < 0) {
+                firstCell[v - 1] = cell;
+                continue;
+            }
+            conflicting[cell / 64] |= 1ULL << (cell % 64);
+            conflicting[firstCell[v - 1] / 64] |= 1ULL << (firstCell[v - 1] % 64);
+        }
+    }
+
+    std::vector<Conflict> conflicts;
+    for (size_t word = 0; word < (cellCount + 63) / 64; word++)
+        for (uint64_t bits = conflicting[word]; bits; bits &= bits - 1) {
+            const size_t cell = word * 64 + static_cast<size_t>(std::countr_zero(bits));
+            conflicts.push_back({static_cast<unsigned short>(cell / dimension), static_cast<unsigned short>(cell % dimension), grid[cell]});
+        }
+    return conflicts;
+}
+
+std::vector<SudokuSolverAlgorithm::Conflict> SudokuSolverAlgorithm::finishLoad(std::vector<Conflict> outOfRange) {
+    solvedInGrid = false;
+    suspended = false;
+
+    std::vector<Conflict> conflicts = validate();
+    if (!outOfRange.empty()) {
+        conflicts.insert(conflicts.end(), outOfRange.begin(), outOfRange.end());
+        std::sort(conflicts.begin(), conflicts.end(), [](const Conflict &a, const Conflict &b) {
+            return a.row != b.row ? a.row < b.row : a.column < b.column;
+        });
+    }
+    return conflicts;
+}
+
+std::vector<SudokuSolverAlgorithm::Conflict> SudokuSolverAlgorithm::load(std::span<const unsigned short> values) {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+
+    // Come clean() e insert() cella per cella, ma in una passata; la soluzione in cache resta
+    std::vector<Conflict> outOfRange;
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        unsigned short v = cell < values.size() ? values[cell] : 0;
+        if (v > dimension) {
+            outOfRange.push_back({static_cast<unsigned short>(cell / dimension), static_cast<unsigned short>(cell % dimension), v});
+            v = 0;
+        }
+        grid[cell] = v;
+        given[cell] = v != 0;
+    }
+    return finishLoad(std::move(outOfRange));
+}
+
+std::vector<SudokuSolverAlgorithm::Conflict> SudokuSolverAlgorithm::loadFromString(std::string_view text) {
+    const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+
+    // Come load(), scrivendo direttamente nella griglia: nessun vettore intermedio
+    std::vector<Conflict> outOfRange;
+    size_t read = 0;
+    bool tooLong = false;
+    for (const char symbol : text) {
+        if (std::isspace(static_cast<unsigned char>(symbol)) || symbol == '|' || symbol == '+' || symbol == '-')
+            continue;
+        if (read == cellCount) {
+            tooLong = true;
+            break;
+        }
+        // Un simbolo estraneo è un valore fuori scala: si segnala e la cella resta vuota
+        unsigned short v = valueFor(symbol, dimension);
+        if (v == 0 && symbol != '.' && symbol != '0') {
+            v = valueFor(symbol, sizeof(alphabet) - 2);
+            outOfRange.push_back({static_cast<unsigned short>(read / dimension), static_cast<unsigned short>(read % dimension),
+                                  v ? v : unknownSymbol});
+            v = 0;
+        }
+        grid[read] = v;
+        given[read] = v != 0;
+        read++;
+    }
+    std::fill(grid + read, grid + cellCount, 0);
+    std::fill(given + read, given + cellCount, 0);
+
+    std::vector<Conflict> conflicts = finishLoad(std::move(outOfRange));
+    // Troppi o troppo pochi simboli: si segnala la prima cella mancante, o l'ultima se ne avanzano
+    if (tooLong || read < cellCount) {
+        const size_t cell = tooLong ? cellCount - 1 : read;
+        const Conflict mismatch{static_cast<unsigned short>(cell / dimension), static_cast<unsigned short>(cell % dimension), 0};
+        if (conflicts.empty() || conflicts.back().row != mismatch.row || conflicts.back().column != mismatch.column)
+            conflicts.push_back(mismatch);
+    }
+    return conflicts;
+}
+
+size_t SudokuSolverAlgorithm::store(std::span<unsigned short> out) const {
+    const size_t count = std::min(out.size(), static_cast<size_t>(dimension) * dimension);
+    std::copy_n(grid, count, out.begin());
+    return count;
+}
+
 size_t SudokuSolverAlgorithm::coordsSize() const {
     std::lock_guard<std::mutex> guard(coordsMutex);
     return coords.size();
@@ -148,16 +1977,55 @@ size_t SudokuSolverAlgorithm::coordsSize() const {
 
 std::pair<unsigned short, unsigned short> SudokuSolverAlgorithm::coordAt(size_t i) const {
     std::lock_guard<std::mutex> guard(coordsMutex);
-    return coords.at(i);
+    const ProgressStep &step = coords.at(i);
+    return {step.row, step.column};
+}
+
+size_t SudokuSolverAlgorithm::progressRange(size_t from, size_t to, std::vector<ProgressStep> &out) const {
+    std::lock_guard<std::mutex> guard(coordsMutex);
+    to = std::min(to, coords.size());
+    if (from >= to)
+        return 0;
+
+    out.insert(out.end(), coords.begin() + static_cast<std::ptrdiff_t>(from), coords.begin() + static_cast<std::ptrdiff_t>(to));
+    return to - from;
 }
 
 void SudokuSolverAlgorithm::pushCoord(unsigned short r, unsigned short c) {
     std::lock_guard<std::mutex> guard(coordsMutex);
-    coords.emplace_back(r, c);
+    coords.push_back({r, c, get(r, c)});
+}
+
+void SudokuSolverAlgorithm::setProgressRecording(bool enabled) {
+    progressEnabled.store(enabled);
+}
+
+void SudokuSolverAlgorithm::setProgressListener(ProgressListener listener) {
+    progressListener = std::move(listener);
+}
+
+size_t SudokuSolverAlgorithm::flushProgress(size_t count) {
+    if (count == 0)
+        return 0;
+
+    const std::span<const ProgressStep> steps(pending, count);
+
+    // Con un listener i passi non restano in memoria
+    if (progressListener) {
+        progressListener(steps);
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> guard(coordsMutex);
+    const size_t capacity = coords.capacity();
+    coords.insert(coords.end(), steps.begin(), steps.end());
+    if (coords.capacity() != capacity)
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    return 0;
 }
 
 void SudokuSolverAlgorithm::clearProgress() {
     std::lock_guard<std::mutex> guard(coordsMutex);
+    // La capacità resta: la prossima risoluzione non rialloca
     coords.clear();
-    coords.shrink_to_fit();
 }
\ No newline at end of file
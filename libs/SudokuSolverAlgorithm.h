@@ -5,6 +5,22 @@
 #include <cmath>
 #include <iostream>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "DeadStateTable.h"
+#include "SolverArena.h"
+#include "SudokuSolverExport.h"
+
+class CheckpointWriter;
+class SearchTraceWriter;
 
 /**
  * @file SudokuSolverAlgorithm.h
@@ -16,31 +32,249 @@
  * Key characteristics:
  * - Supports square Sudoku of size `dimension x dimension` where `dimension`
  *   is typically 9, and the sub-block size is `sqrt(dimension)` (e.g. 3 for 9x9).
+ *   Candidates are 64-bit masks, so any size up to 64x64 works; 25x25 and
+ *   36x36 are solved in well under a second.
+ * - Values are written with a fixed alphabet, 1-9 then A-Z then 0
+ *   (`symbolFor`/`valueFor`), so one character covers every value up to 36.
  * - Provides basic input methods (`insert`, `clean`), validity checks (`isSafe`),
  *   a synchronous solver entry point (`solve`), and read-back utilities (`get`).
  * - Exposes a small, thread-safe progress buffer (`coords`, guarded by a mutex)
  *   to mirror incremental placements while solving on a background thread.
+ *   Each step carries the new value of the cell (0 on backtrack); the search
+ *   publishes steps in batches, so the lock is taken once per batch.
+ * - Keeps the last solution between runs (warm start): after a clue is edited,
+ *   `solve()` returns the cached solution if it still fits, otherwise it
+ *   re-solves following the cached values instead of starting from scratch.
+ * - A stopped search keeps its state: `resume()` continues it, and
+ *   `serialize()`/`deserialize()` carry it (with the puzzle) across restarts.
+ *   With `setCheckpointing()` a long search also saves itself to a file at a
+ *   fixed interval, and `resume(path)` picks it up after a crash.
+ *   `setTracing()` logs every step of the search to a compact binary file
+ *   for offline analysis.
+ * - `enumerateSolutions()` streams every solution of an under-constrained grid
+ *   to a callback or a compressed stream, optionally on several threads;
+ *   `nextSolution()` pulls them one at a time.
  *
  * Usage notes:
  * - Create an instance with the desired dimension, populate initial clues with
  *   `insert`, then call `solve()`. After completion, read values via `get()`.
+ * - `findHint()` looks for the next logically forced placement without solving
+ *   the whole puzzle; it is bounded by a time budget.
+ * - Editing a clue after a solve (`insert`/`clean`) drops the solved values
+ *   from the grid, leaving only the clues, but keeps the cached solution.
  * - When used from multiple threads, only the progress methods (`coordsSize`,
- *   `coordAt`, `pushCoord`) are thread-safe. Other methods should be called
+ *   `coordAt`, `progressRange`, `pushCoord`) are thread-safe. Other methods should be called
  *   in a controlled context (e.g., single worker thread) while the UI only
  *   reads progress.
  */
 
-class SudokuSolverAlgorithm {
+/**
+ * @brief Compact, self-contained copy of a solver's puzzle state.
+ *
+ * One byte per cell for the values, one bit per cell for the clues and the
+ * row/column/box masks of the used values, all in a single buffer: copying a
+ * 16x16 state copies about 700 bytes. The cached solution, which is larger
+ * and read-only, is shared by reference; whoever writes a new one copies it
+ * first (copy-on-write).
+ *
+ * Obtained with `SudokuSolverAlgorithm::snapshot()`, applied with `restore()`.
+ */
+class SUDOKUSOLVER_EXPORT SolverState {
+public:
+    /** @brief Grid size, 0 for a default-constructed state. */
+    [[nodiscard]] unsigned short dimension() const { return dim; }
+    /** @brief Value of a cell, 0 if empty. */
+    [[nodiscard]] unsigned short value(unsigned short row, unsigned short column) const {
+        return bytes[static_cast<size_t>(row) * dim + column];
+    }
+    /** @brief true if the cell holds a clue. */
+    [[nodiscard]] bool isGiven(unsigned short row, unsigned short column) const {
+        const size_t cell = static_cast<size_t>(row) * dim + column;
+        return (clueWords()[cell / 64] >> (cell % 64)) & 1;
+    }
+    /** @brief Values still allowed in a cell (bit v - 1 for value v); 0 for filled cells. */
+    [[nodiscard]] uint64_t candidates(unsigned short row, unsigned short column) const {
+        if (value(row, column))
+            return 0;
+        const uint64_t all = dim >= 64 ? ~0ULL : (1ULL << dim) - 1;
+        const unsigned short box = (row / block) * block + column / block;
+        return all & ~(masks()[row] | masks()[dim + column] | masks()[2 * dim + box]);
+    }
+
+private:
+    friend class SudokuSolverAlgorithm;
+
+    /** @brief Buffer size for a dimension: values, clue bits, then 3 x dimension masks. */
+    static size_t bytesFor(unsigned short dimension) {
+        return maskOffset(dimension) + 3 * static_cast<size_t>(dimension) * sizeof(uint64_t);
+    }
+    /** @brief Offset of the clue bits, 8-byte aligned after the values. */
+    static size_t clueOffset(unsigned short dimension) {
+        return (static_cast<size_t>(dimension) * dimension + 7) / 8 * 8;
+    }
+    /** @brief Offset of the masks, after the clue bits. */
+    static size_t maskOffset(unsigned short dimension) {
+        const size_t cellCount = static_cast<size_t>(dimension) * dimension;
+        return clueOffset(dimension) + (cellCount + 63) / 64 * sizeof(uint64_t);
+    }
+
+    uint64_t *clueWords() { return reinterpret_cast<uint64_t *>(bytes.data() + clueOffset(dim)); }
+    const uint64_t *clueWords() const { return reinterpret_cast<const uint64_t *>(bytes.data() + clueOffset(dim)); }
+    uint64_t *masks() { return reinterpret_cast<uint64_t *>(bytes.data() + maskOffset(dim)); }
+    const uint64_t *masks() const { return reinterpret_cast<const uint64_t *>(bytes.data() + maskOffset(dim)); }
+
+    unsigned short dim = 0;
+    unsigned short block = 0;
+    /** Whether the values include solved cells besides the clues. */
+    bool solved = false;
+    /** Values, clue bits and masks; see the offsets above. */
+    std::vector<uint8_t> bytes;
+    /** Cached solution, shared with the solver (copy-on-write); null if none. */
+    std::shared_ptr<const std::vector<unsigned short>> solution;
+};
+
+class SUDOKUSOLVER_EXPORT SudokuSolverAlgorithm {
+public:
+    /** Logical technique that justifies a hint, from the simplest. */
+    enum class HintTechnique {
+        /** No forced placement found (or the time budget ran out). */
+        None,
+        /** The cell at `row`/`column` has no candidate left: some clue is wrong. */
+        Contradiction,
+        /** The cell has a single candidate. */
+        NakedSingle,
+        /** The value fits only this cell of a row, column or block. */
+        HiddenSingle,
+        /** A single, found after locked-candidate (pointing/claiming) eliminations. */
+        LockedCandidates
+    };
+
+    /** Search engine used by `solve()` and `countSolutions()`. */
+    enum class Engine {
+        /** Depth-first search with singles propagation: progress steps, warm start, resume. */
+        Backtracking,
+        /**
+         * The grid encoded as CNF and solved by the built-in CDCL solver (SatSolver.h).
+         * Records no progress steps and cannot be resumed once stopped.
+         */
+        Sat
+    };
+
+    /** Order in which a decision on a cell tries its values. */
+    enum class ValueOrder {
+        /** Ascending values (default). */
+        Ascending,
+        /** First the value found among the candidates of the fewest peers of the cell. */
+        LeastConstraining
+    };
+
+    /** When the backtracking search gives up its current tree and starts again. */
+    enum class RestartPolicy {
+        /** Never (default). */
+        None,
+        /** After `restartBase` times 1, 1, 2, 1, 1, 2, 4, ... decisions. */
+        Luby,
+        /** After `restartBase` decisions, growing by `restartGrowth` each time. */
+        Geometric
+    };
+
+    /**
+     * Deductions the backtracking search makes at every node, each level
+     * including the previous ones. Higher levels cost more per node and
+     * take fewer decisions.
+     */
+    enum class PropagationLevel {
+        /** Naked and hidden singles (default). */
+        Singles,
+        /** Pointing and claiming: a value locked in a box-line intersection. */
+        LockedCandidates,
+        /** Naked and hidden pairs and triples. */
+        Subsets,
+        /** X-wing and Swordfish. */
+        Fish
+    };
+
+    /** Heuristics of the backtracking search; see `setSearchOptions()`. */
+    struct SearchOptions {
+        PropagationLevel propagation = PropagationLevel::Singles;
+        ValueOrder valueOrder = ValueOrder::Ascending;
+        /**
+         * Seed of the random tie-breaks between equally good values and cells;
+         * 0 keeps the search deterministic (lowest value, first cell).
+         */
+        uint64_t seed = 0;
+        RestartPolicy restarts = RestartPolicy::None;
+        /** Decisions of the first run. */
+        uint64_t restartBase = 100;
+        /** Growth of the budget between runs with RestartPolicy::Geometric. */
+        double restartGrowth = 1.5;
+    };
+
+    /** One recorded change of a cell during a solve. */
+    struct ProgressStep {
+        unsigned short row;
+        unsigned short column;
+        /** New value of the cell; 0 when the solver backtracked and emptied it. */
+        unsigned short value;
+    };
+
+    /** Counters of a search; `resume()` and checkpoints carry them over. */
+    struct SearchStatistics {
+        /** Branching decisions taken. */
+        uint64_t decisions = 0;
+        /** Placements that led to a contradiction (dead branches). */
+        uint64_t conflicts = 0;
+        /** Cells filled, by decisions and by propagation. */
+        uint64_t placements = 0;
+        /** Branches cut because the dead-state table already knew them (see `setDeadStateTable()`). */
+        uint64_t deadStateHits = 0;
+        /** Times the search started again from the clues (see `SearchOptions::restarts`). */
+        uint64_t restarts = 0;
+        /** Time spent searching, over every resumed run. */
+        std::chrono::nanoseconds elapsed{0};
+    };
+
+    /** A forced placement returned by `findHint()`. */
+    struct Hint {
+        unsigned short row = 0;
+        unsigned short column = 0;
+        /** Value to place, in [1, dimension]; 0 when `technique` is None or Contradiction. */
+        unsigned short value = 0;
+        HintTechnique technique = HintTechnique::None;
+    };
+
+    /** A cell rejected by `validate()` or `load()`. */
+    struct Conflict {
+        unsigned short row = 0;
+        unsigned short column = 0;
+        /** The value that repeats in the cell's row, column or block, or is out of range. */
+        unsigned short value = 0;
+    };
+
+    /** Value reported by `loadFromString()` for a symbol outside the alphabet. */
+    static constexpr unsigned short unknownSymbol = 0xFFFF;
+
 private:
     /** Overall puzzle dimension (e.g., 9 for a 9x9 Sudoku). */
     unsigned short dimension;
     /** Sub-square side length, computed as `sqrt(dimension)` (e.g., 3 for 9x9). */
     unsigned short blockSize;
     /**
-     * Backing grid, allocated as a `dimension x dimension` matrix of unsigned short.
+     * Holds every array below in one buffer, carved by `reset()`. Solving never
+     * allocates: the arena is only reallocated when a larger dimension needs it.
+     */
+    SolverArena arena;
+    /**
+     * Backing grid, `dimension x dimension` values in row-major order (in the arena).
      * Values are 0 for empty cells, 1..dimension for filled cells.
      */
-    unsigned short **grid;
+    unsigned short *grid = nullptr;
+    /** Marks the cells holding clues inserted with `insert()`, row-major (1 = clue). */
+    unsigned char *given = nullptr;
+    /** True while the grid holds solved values besides the clues. */
+    bool solvedInGrid = false;
+    /** Heap allocations made by this solver (arena and progress buffer growth). */
+    std::atomic<size_t> allocations{0};
 
     public:
     /**
@@ -57,6 +291,48 @@ private:
      * @brief Frees the allocated grid and internal resources.
      */
     ~SudokuSolverAlgorithm();
+
+    /**
+     * @brief Turns the solver into a new, empty one of the given size, reusing its memory.
+     * @param dimension Grid size (e.g., 9 for 9x9), a perfect square up to 64.
+     *
+     * Like `clean()` it drops the clues, the cached solution and the progress
+     * buffer, but keeps their capacity: no memory is allocated unless the new
+     * dimension needs more than the solver ever held.
+     */
+    void reset(unsigned short dimension);
+
+    /**
+     * @brief Captures the puzzle state (values, clues, cached solution) as a value.
+     *
+     * The state can be restored later into this or another solver, e.g. to
+     * explore an alternative and come back, or to hand a subtree to another thread.
+     */
+    [[nodiscard]] SolverState snapshot() const;
+
+    /**
+     * @brief Puts back a state taken with `snapshot()`.
+     *
+     * A state of another dimension resets the solver to that dimension first.
+     * The search progress buffer is left untouched.
+     */
+    void restore(const SolverState &state);
+
+    /**
+     * @brief A new solver with a copy of this one's puzzle (see the copy constructor).
+     */
+    [[nodiscard]] std::unique_ptr<SudokuSolverAlgorithm> clone() const;
+
+    /**
+     * @brief Number of heap allocations this solver has made since construction.
+     *
+     * Counts only the arena (re)allocations and the growth of the progress
+     * buffer, not the values returned to the caller (conflict lists, hints,
+     * snapshots, serialized states), which are the caller's. Once a solver has
+     * run at a given size, loading (`load()`, `loadFromString()`) and solving
+     * a valid grid at that size allocate nothing and leave this number unchanged.
+     */
+    [[nodiscard]] size_t allocationCount() const;
 	
  /**
   * @brief Inserts a value at the given cell as an initial (fixed) clue.
@@ -66,17 +342,298 @@ private:
   *
   * If `row`/`column` are out of bounds or `value` is 0/out of range, the call
   * has no effect. No validity checks against Sudoku rules are performed here.
+  * If the grid holds a previous solution, the solved (non-clue) cells are
+  * emptied first; the solution itself stays cached for the next `solve()`.
   */
  void insert(const unsigned short & value, const unsigned short & row, const unsigned short & column);
 
+ /**
+  * @brief Replaces every clue with a whole grid in one call.
+  * @param values Row-major, `dimension * dimension` values; 0 for empty cells.
+  *        Missing values leave their cells empty, extra ones are ignored.
+  * @return Every conflicting cell, row-major (see `validate()`); empty if the
+  *         grid is valid. Out-of-range values are reported and left empty.
+  *
+  * Same effect as `clean()`ing every cell and `insert()`ing each nonzero
+  * value, without the per-cell calls; the cached solution is kept.
+  */
+ std::vector<Conflict> load(std::span<const unsigned short> values);
+
+ /**
+  * @brief Replaces every clue with a grid written as text.
+  * @param text One symbol per cell, row-major (see `valueFor()`); '.' and
+  *        '0' are empty cells. Whitespace and the separators `|`, `+` and `-`
+  *        are skipped.
+  * @return As `load()`. A symbol past the dimension is reported with its
+  *         value, one outside the alphabet with `unknownSymbol`; both cells
+  *         are left empty. Text with fewer symbols than cells also reports
+  *         the first missing cell, text with more the last cell, with value 0.
+  */
+ std::vector<Conflict> loadFromString(std::string_view text);
+
+ /**
+  * @brief Copies the whole grid (clues and solved values) in one call.
+  * @param out Receives up to `dimension * dimension` values, row-major.
+  * @return Number of values written.
+  */
+ size_t store(std::span<unsigned short> out) const;
+
+ /**
+  * @brief Checks every row, column and block in a single pass over the grid.
+  * @return Each cell whose value also appears elsewhere in one of its units,
+  *         once, row-major; empty if the grid is valid.
+  */
+ [[nodiscard]] std::vector<Conflict> validate() const;
+
  /**
   * @brief Attempts to solve the puzzle using backtracking.
   * @return true if a complete solution is found; false otherwise (e.g., invalid setup).
   *
   * This is a synchronous call that explores the search space depth-first.
-  * It assumes the current grid contains the initial clues and empty cells (0).
+  * Naked and hidden singles are filled in after every decision, and each
+  * decision is made on the cell with the fewest candidates.
+  * Only the clues are kept: solved values left by a previous run are cleared.
+  *
+  * Warm start: if a previous solution is cached and every current clue agrees
+  * with it, it is returned immediately without searching. Otherwise the search
+  * tries the cached value of each cell first, so it runs straight through the
+  * part of the previous solution that is still consistent and only branches
+  * from the first conflicting cell onwards.
+  *
+  * @param engine Engine::Sat solves through a CNF encoding instead; the cached
+  *        solution then only sets the first value tried for each variable.
+  */
+ bool solve(Engine engine = Engine::Backtracking);
+
+ /**
+  * @brief Counts the solutions of the current clues, up to a limit.
+  * @param limit Stop as soon as this many solutions are found (2 checks uniqueness).
+  * @return Number of solutions found, at most `limit`; 0 if the clues are invalid.
+  *
+  * Like `solve()`, this starts from the clues only and leaves the first solution
+  * found in the grid (and in the cache). No progress is recorded.
+  * With Engine::Sat each solution found is excluded by a blocking clause
+  * before looking for the next one.
+  */
+ unsigned long countSolutions(unsigned long limit, Engine engine = Engine::Backtracking);
+
+ /** Receives each solution of an enumeration, row-major; returns false to stop it. */
+ using SolutionCallback = std::function<bool(std::span<const unsigned short> solution)>;
+
+ /**
+  * @brief Enumerates every solution of the current clues without storing them.
+  * @param callback Called once per solution; the span is only valid during the call.
+  * @param threads With more than one, the solution space is split into disjoint
+  *        subtrees (one per branch of the first decisions) solved by that many
+  *        threads. The callback is then called from those threads, one call at a
+  *        time, and solutions arrive in no particular order.
+  * @return Number of solutions passed to the callback.
+  *
+  * Memory stays the same however many solutions there are: the search keeps
+  * only its current path. A single-threaded enumeration stopped by the callback
+  * or by `requestStop()` can be continued with `nextSolution()`.
+  * No progress is recorded; the grid ends with the first solution, as after
+  * `countSolutions()`.
+  */
+ unsigned long enumerateSolutions(const SolutionCallback &callback, unsigned int threads = 1);
+
+ /**
+  * @brief Enumerates every solution of the current clues into a compressed stream.
+  * @return Number of solutions written (see SolutionStream.h for the format).
+  */
+ unsigned long enumerateSolutions(std::ostream &out, unsigned int threads = 1);
+
+ /**
+  * @brief Pull-style enumeration: puts the next solution of the clues in the grid.
+  * @return false when there are no more solutions, or if the call was stopped
+  *         with `requestStop()` (`canResume()` is then true).
+  *
+  * The first call starts from the clues; each later call continues where the
+  * previous one stopped, until the puzzle is edited or another search runs.
+  * After the last solution the next call starts over.
+  */
+ bool nextSolution();
+
+ /**
+  * @brief Asks a running `solve()` or `countSolutions()` to stop (thread-safe).
+  *
+  * The running call returns as soon as possible, with the grid back to the clues.
+  * The request is cleared when that call returns; if nothing is running, it makes
+  * the next call return immediately. The search state is kept, so the call can
+  * be continued with `resume()`.
+  */
+ void requestStop();
+
+ /**
+  * @brief Withdraws a stop request that no call has consumed yet (thread-safe).
+  *
+  * A `requestStop()` that arrives after the search has already returned would
+  * make the next call return immediately; this drops it without touching the
+  * grid or the stopped search.
+  */
+ void clearStopRequest();
+
+ /**
+  * @brief Tells whether a stopped `solve()` or `countSolutions()` can be continued.
+  *
+  * Editing the puzzle (`insert`, `clean`, `restore`, ...) or starting a new
+  * solve drops the stopped search.
+  */
+ [[nodiscard]] bool canResume() const;
+
+ /**
+  * @brief Continues the stopped search exactly where it left off.
+  * @return What the stopped call would have returned: 1 or 0 for `solve()`,
+  *         the number of solutions (counting those found before the stop) for
+  *         `countSolutions()`. Without a stopped search this is `solve()`.
+  *
+  * With progress recording on, the cells already filled by the stopped search
+  * are reported first, so a view starting from the clues catches up. The call
+  * can be stopped again and resumed later.
   */
- bool solve();
+ unsigned long resume();
+
+ /**
+  * @brief Continues the search saved in a checkpoint file.
+  * @param checkpointPath File written by `setCheckpointing()`.
+  * @return As `resume()`; 0 if the file cannot be read (`canResume()` is then false).
+  *
+  * Equivalent to `loadCheckpoint()` followed by `resume()`. A checkpoint of a
+  * finished solve holds its solution, so resuming it returns at once.
+  */
+ unsigned long resume(const std::string &checkpointPath);
+
+ /**
+  * @brief Loads the puzzle and stopped search saved in a checkpoint file.
+  * @return false if the file cannot be read or is not a valid state.
+  */
+ bool loadCheckpoint(const std::string &checkpointPath);
+
+ /**
+  * @brief Makes the next searches save their full state to a file periodically.
+  * @param path Checkpoint file; an empty path turns checkpointing off.
+  * @param interval Time between two checkpoints.
+  *
+  * The search serializes its state (a few KB) in place and a writer thread
+  * puts it on disk, through a temporary file that is synced before a rename,
+  * so the file always holds a complete checkpoint, even after a power loss.
+  * The final state is written when the search ends or is stopped. Set it while no search is running. A write that fails
+  * does not stop the search; check `checkpointError()`.
+  */
+ void setCheckpointing(const std::string &path, std::chrono::milliseconds interval = std::chrono::seconds(60));
+
+ /**
+  * @brief Why the last checkpoint could not be written (full disk, unwritable path...).
+  * @return An empty error if it was written, or if checkpointing is off or nothing was written yet.
+  */
+ [[nodiscard]] std::error_code checkpointError() const;
+
+ /**
+  * @brief Records every step of the next backtracking searches into a binary trace file.
+  * @param path Trace file, replaced; an empty path turns tracing off.
+  * @return false if the file cannot be created (tracing stays off).
+  *
+  * Decisions, alternatives tried, propagation batches and backtracks are
+  * appended as a few varint bytes each (see SearchTrace.h) to a memory block
+  * that a writer thread puts on disk. The file is complete once tracing is
+  * turned off or the solver is destroyed; `SudokuTrace` analyzes it. The SAT
+  * engine is not traced. Set it while no search is running.
+  */
+ bool setTracing(const std::string &path);
+
+ /**
+  * @brief Sets the propagation level, value ordering, random tie-breaks and restarts of the backtracking search.
+  *
+  * Above PropagationLevel::Singles the search keeps, besides the values used
+  * by each row, column and box, the candidates eliminated by deductions at
+  * each cell; eliminations are undone with the decisions that led to them.
+  * A resumed search starts again without the eliminations of the stopped one.
+  * Puzzles of the same size can differ by orders of magnitude in search time,
+  * mostly because an early wrong decision is only undone after its whole
+  * subtree has been explored. Least-constraining values make that rarer; a seed
+  * breaks ties at random (the value among equal scores, and the first cell
+  * looked at when picking the one with fewest candidates), so each run takes
+  * different early decisions; restarts cut a run that exceeds its decision
+  * budget and try again with the next random choices. Restarts only happen
+  * before the first solution, so counting stays exact, and go best with
+  * `setDeadStateTable()`, which keeps what the abandoned runs proved.
+  * Restarts without a seed use a fixed one. A resumed search is still correct
+  * but does not replay the random choices of the stopped one.
+  *
+  * The defaults are the deterministic search of earlier versions.
+  */
+ void setSearchOptions(const SearchOptions &options);
+ /** @brief The options set with `setSearchOptions()`. */
+ [[nodiscard]] const SearchOptions &searchOptions() const { return options; }
+
+ /**
+  * @brief Gives the backtracking search a table of partial grids known to have no solution.
+  * @param bytes Memory budget of the table; 0 (the default) turns it off.
+  *
+  * Each time a decision runs out of alternatives without finding a solution,
+  * the grid it started from is recorded by its Zobrist hash (kept up to date
+  * on every placement); a branch that reaches a recorded grid is cut at once.
+  * A single search never reaches the same grid twice, so the table pays off
+  * over several searches: a solve followed by a uniqueness check, counts
+  * after editing the puzzle, restarted searches. Entries stay valid across
+  * edits and are only dropped when the dimension changes; when the table is
+  * full, entries of earlier searches and small subtrees are replaced first.
+  * Copies of the solver start without a table.
+  */
+ void setDeadStateTable(size_t bytes);
+
+ /**
+  * @brief Counters of the last search, including the runs it was resumed from.
+  *
+  * Read it once the search has returned.
+  */
+ [[nodiscard]] SearchStatistics statistics() const;
+
+ /**
+  * @brief Appends the solver state to a compact binary buffer.
+  * @param out Buffer the state is appended to.
+  *
+  * Stores the dimension, the grid, the clues (one bit per cell), the cached
+  * solution and, if any, the stopped search (its working grid, filled cells and
+  * decision stack, and its statistics), one byte per value: a 16x16 puzzle
+  * with its solution takes under 600 bytes.
+  * Integers are little-endian, so the buffer can be saved to a file and loaded
+  * on any machine.
+  */
+ void serialize(std::vector<uint8_t> &out) const;
+
+ /**
+  * @brief Loads a state written by `serialize()`, resizing the solver if needed.
+  * @param data The serialized state.
+  * @return false if the data is not a valid state; the solver is then empty.
+  */
+ bool deserialize(std::span<const uint8_t> data);
+
+ /**
+  * @brief Finds the next logically forced placement, without solving the puzzle.
+  * @param budget Time budget; when it runs out the search stops and returns None.
+  * @return The first naked or hidden single found, from the simplest technique.
+  *
+  * Candidates are computed from the current grid. If no single exists, pointing
+  * and claiming eliminations are applied and singles are looked for again,
+  * until nothing changes. The grid itself is never modified.
+  */
+ [[nodiscard]] Hint findHint(std::chrono::microseconds budget = std::chrono::milliseconds(10)) const;
+
+ /**
+  * @brief Every placement forced by logic alone, in the order it is deduced.
+  * @return The placements, each with the technique that justifies it. If the
+  *         deductions reach a contradiction the list ends with a Contradiction
+  *         entry: a cell left without candidates, or (with `value` set) the
+  *         first empty cell of a unit where that value has no place left.
+  *
+  * Naked and hidden singles are placed until none is left, then locked
+  * candidates are eliminated and singles looked for again, up to a fixpoint.
+  * Nothing is guessed, so the result is the same however the puzzle is
+  * solved; the grid itself is never modified. Each placement only updates its
+  * peers, so a 9x9 takes microseconds and a 16x16 well under a millisecond.
+  */
+ [[nodiscard]] std::vector<Hint> forcedPlacements() const;
 
  /**
   * @brief Prints the grid to stdout for debugging purposes.
@@ -87,14 +644,36 @@ private:
   * @brief Clears a single cell (sets it to 0).
   * @param row Zero-based row index.
   * @param column Zero-based column index.
+  *
+  * Like `insert()`, this empties the solved cells but keeps the cached solution.
   */
  void clean(const unsigned short & row, const unsigned short & column);
 
  /**
   * @brief Clears the entire grid (sets all cells to 0).
+  *
+  * This starts a new puzzle: the cached solution and search state are dropped.
   */
  void clean();
 
+ /**
+  * @brief Tells whether a cell holds a clue inserted with `insert()`.
+  * @param row Zero-based row index.
+  * @param column Zero-based column index.
+  * @return true for clue cells; false for empty, solved or out-of-bounds cells.
+  */
+ [[nodiscard]] bool isGiven(const unsigned short & row, const unsigned short & column) const;
+
+ /**
+  * @brief Tells whether a solution from a previous `solve()` is cached.
+  */
+ [[nodiscard]] bool hasCachedSolution() const;
+
+ /**
+  * @brief Empties every non-clue cell, keeping the clues and the cached solution.
+  */
+ void resetToClues();
+
     /**
      * @brief Checks whether placing a number at the given position is valid.
      * @param row Zero-based row index.
@@ -104,6 +683,24 @@ private:
      */
     [[nodiscard]] bool isSafe(const unsigned short & row, const unsigned short & col, const unsigned short & num) const;
 
+ /**
+  * @brief Character used for a value: 1-9, then A-Z, then 0 for 36.
+  * @param value Value in [0, 36]; 0 (empty) gives '.'.
+  * @return The symbol, or '?' past the alphabet.
+  */
+ [[nodiscard]] static char symbolFor(unsigned short value);
+
+ /**
+  * @brief Value written with a symbol, case-insensitive.
+  * @param symbol Character of the alphabet.
+  * @param dimension Grid size; symbols of larger values are rejected.
+  * @return The value in [1, dimension], or 0 for anything else (including '.').
+  */
+ [[nodiscard]] static unsigned short valueFor(char symbol, unsigned short dimension);
+
+ /** @brief Grid size (e.g., 9 for 9x9). */
+ [[nodiscard]] unsigned short size() const { return dimension; }
+
  /**
   * @brief Reads the value at a cell.
   * @param row Zero-based row index.
@@ -126,20 +723,52 @@ private:
      * @param i Zero-based index into the progress buffer, in range [0, coordsSize()).
      */
     std::pair<unsigned short, unsigned short> coordAt(size_t i) const;
+    /**
+     * @brief Copies the recorded steps in [from, to) with a single lock.
+     * @param from First step to copy.
+     * @param to One past the last step to copy; clamped to `coordsSize()`.
+     * @param out Vector the steps are appended to (its capacity is reused).
+     * @return Number of steps appended.
+     */
+    size_t progressRange(size_t from, size_t to, std::vector<ProgressStep> &out) const;
     ///@}
 
     /**
      * @brief Appends a coordinate to the progress buffer (thread-safe).
      * @param r Row index.
      * @param c Column index.
+     *
+     * The step records the current value of the cell.
      */
     void pushCoord(unsigned short r, unsigned short c);
 
+    /**
+     * @brief Enables or disables progress recording for the next solves.
+     *
+     * With recording off the solver does no locking at all and the buffer
+     * stays empty: useful when only the final result is shown.
+     */
+    void setProgressRecording(bool enabled);
+
+    /** Receives the steps of a solve, one batch at a time. */
+    using ProgressListener = std::function<void(std::span<const ProgressStep> steps)>;
+
+    /**
+     * @brief Sends the steps of the next solves to a callback instead of the buffer.
+     * @param listener Called on the solving thread for each batch of steps; an
+     *        empty function restores the progress buffer.
+     *
+     * Steps go to the listener even when progress recording is off, and the
+     * buffer stays empty. Not thread-safe: set it while no solve is running.
+     */
+    void setProgressListener(ProgressListener listener);
+
     /**
      * @brief Clears the solver progress buffer (thread-safe).
      *
      * Call this before starting a new solve to avoid unbounded growth of
-     * the `coords` vector across multiple runs.
+     * the `coords` vector across multiple runs. The capacity is kept, so the
+     * next solve records its steps without reallocating.
      */
     void clearProgress();
 
@@ -148,26 +777,264 @@ private:
     /**
      * @brief Validates the current grid state against Sudoku constraints.
      * @return false if any preset value violates rules; true otherwise.
+     *
+     * One pass over the grid with a bitmask per unit, stopping at the first
+     * repeat; `validate()` lists every conflict instead.
      */
     [[nodiscard]] bool checkAll() const;
 
     /**
-     * @brief Core backtracking routine.
-     * @param row Current row being explored.
-     * @param column Current column being explored.
-     * @return true if a solution is found from this state; false to backtrack.
+     * @brief Core backtracking routine, iterative over an explicit trail.
+     * @param limit Number of solutions after which the search stops.
+     * @param recordProgress Whether placements are pushed to the progress buffer.
+     * @return Number of solutions found; the first one is cached and left in the grid.
+     *
+     * Naked and hidden singles are propagated after each placement, then the
+     * empty cell with the fewest candidates is branched on, or a value with
+     * only two places left in some unit if no cell has two candidates. When a solution is
+     * cached, each decision tries its cached value first and then the others
+     * in ascending order. Every placement and undo is a progress step.
+     * The search works on a flat copy of the grid; `grid` is written once, at the end.
+     *
+     * If stopped before it is done, the workspace is left as it is and `suspended`
+     * is set; `resuming` continues from that workspace instead of the clues.
+     * Each solution is shown to `solutionVisitor`, if set; when it returns false
+     * the search stops there as if stopped, and resuming moves on to the next one.
+     */
+    unsigned long search(unsigned long limit, bool recordProgress, bool resuming = false);
+
+    /**
+     * @brief Splits the clues into disjoint subproblems for a parallel enumeration.
+     * @param target Splitting stops once there are at least this many.
+     * @return Clue grids, row-major: each is the clues plus a few decided cells.
+     *
+     * Branches breadth-first on the empty cell with the fewest candidates; the
+     * branches of a cell cover all of its values, so every solution belongs to
+     * exactly one subproblem. Subproblems left without candidates are dropped.
      */
-    bool solveRecursive(unsigned short row, unsigned short column);
+    [[nodiscard]] std::vector<std::vector<unsigned short>> splitClues(size_t target) const;
+
+    /**
+     * @brief SAT engine: encodes the clues as CNF and solves it with SatSolver.
+     * @param limit Number of solutions after which the search stops.
+     * @return Number of solutions found; the first one is cached and left in the grid.
+     *
+     * One variable per candidate value of each empty cell (values excluded by
+     * the clues get none) and a unit clause per clue. Each cell and each
+     * value of a unit needs at least one true variable and at most one; the
+     * at-most-one constraints are pairwise for up to four variables and a
+     * sequential counter above that, which keeps them linear in size.
+     * Statistics count the solver's decisions, conflicts and propagations.
+     */
+    unsigned long searchSat(unsigned long limit);
+
+    /**
+     * @brief Deductions beyond singles on the search workspace, up to `level`.
+     * @param changed Set to true if a candidate was removed.
+     * @return false if a cell is left without candidates.
+     *
+     * Refreshes `cand` from the used masks and `eliminated`, then applies
+     * locked candidates (`eliminateLockedCandidates()`, shared with the hints),
+     * naked and hidden pairs and triples, X-wing and Swordfish, all on the
+     * per-cell and per-unit candidate bitsets.
+     * Removed candidates go to `eliminated` and the `eliminations` trail.
+     */
+    bool pruneCandidates(PropagationLevel level, bool &changed);
+
+    /** A candidate removed by a deduction: value `bit + 1` at `cell`. */
+    struct Elimination {
+        unsigned short cell;
+        unsigned short bit;
+    };
+
+    /**
+     * @brief Removes candidates with pointing and claiming (locked candidates).
+     * @param cand Candidate mask of each cell, row-major; 0 for filled cells.
+     * @param changed Set to true if a candidate was removed.
+     * @param removed, trail, trailSize Null on a scratch copy (hints). The search
+     *        passes `eliminated`, `eliminations` and `&eliminationCount`: removed
+     *        candidates are also marked in `removed` and appended to `trail`,
+     *        to be undone on backtrack. Nothing else is written.
+     * @return false if a cell is left without candidates; it stops there.
+     */
+    bool eliminateLockedCandidates(uint64_t *cand, bool &changed, uint64_t *removed = nullptr,
+                                   Elimination *trail = nullptr, size_t *trailSize = nullptr) const;
+
+    /** @brief Row-major index of the k-th cell of unit `u` (rows, then columns, then blocks). */
+    [[nodiscard]] unsigned short unitCell(unsigned short u, unsigned short k) const;
+
+    /** @brief true if a solution is cached and agrees with every current clue. */
+    [[nodiscard]] bool solutionFitsClues() const;
+
+    /**
+     * One decision of the search and what to undo on backtrack. It branches either
+     * on the values of a cell or, when `value` is set, on the cells of a unit
+     * where that value can go.
+     */
+    struct Frame {
+        /** Row-major cell index, or unit index (see `unitCell`) when `value` is set. */
+        unsigned short cell;
+        /** Alternatives not tried yet: bit v - 1 for value v, or bit k for the k-th cell of the unit. */
+        uint64_t remaining;
+        /** Number of placed cells before the decision; later ones are undone on backtrack. */
+        unsigned int mark;
+        /** Value placed in the unit; 0 for a decision on a cell. */
+        unsigned short value;
+        /** Number of eliminated candidates before the decision (not saved with the state). */
+        unsigned int eliminationMark;
+    };
+
+    /** Symbols of the values, index = value; index 0 is the empty cell. */
+    static constexpr char alphabet[] = ".123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ0";
+
+    /** @brief Takes every array from the arena (or only measures them). */
+    void carveArena();
+
+    /**
+     * @brief Ends `load()` or `loadFromString()` once the grid is written.
+     * @param outOfRange Rejected cells, row-major, to merge with `validate()`.
+     */
+    std::vector<Conflict> finishLoad(std::vector<Conflict> outOfRange);
+
+    /** Steps collected by the search before one publication. */
+    static constexpr size_t progressBatch = 1024;
+
+    /**
+     * Last solution found, row-major; valid if `hasSolution`. Shared with clones
+     * and snapshots, so it is copied before being overwritten.
+     */
+    std::shared_ptr<std::vector<unsigned short>> solution;
+    bool hasSolution = false;
+
+    /** Lookup tables of one dimension, immutable and shared by every solver of that size. */
+    struct Tables {
+        unsigned short dimension = 0;
+        std::vector<unsigned short> rowOf, colOf, boxOf;
+        /** Cells of each unit: rows, then columns, then boxes, `dimension` cells each. */
+        std::vector<unsigned short> units;
+        /** Zobrist key of each cell and value, at `cell * dimension + value - 1`. */
+        std::vector<uint64_t> zobrist;
+
+        /** @brief The tables of a dimension, built on first use (thread-safe). */
+        static std::shared_ptr<const Tables> forDimension(unsigned short dimension);
+    };
+    std::shared_ptr<const Tables> tables;
+
+    /** @name Fixed tables of the dimension (point into `tables`): row, column, box of each cell, cells of each unit */
+    ///@{
+    const unsigned short *rowOf = nullptr;
+    const unsigned short *colOf = nullptr;
+    const unsigned short *boxOf = nullptr;
+    const unsigned short *units = nullptr;
+    ///@}
+
+    /** @name Search workspace (contents only meaningful during `search()`) */
+    ///@{
+    unsigned short *value = nullptr;
+    unsigned short *phase = nullptr;
+    unsigned short *empty = nullptr;
+    unsigned short *placed = nullptr;
+    uint64_t *cand = nullptr;
+    uint64_t *rowUsed = nullptr;
+    uint64_t *colUsed = nullptr;
+    uint64_t *boxUsed = nullptr;
+    /** Candidates removed from each cell by deductions beyond singles. */
+    uint64_t *eliminated = nullptr;
+    /** Removed candidates in order, `eliminationCount` of them, to be undone on backtrack. */
+    Elimination *eliminations = nullptr;
+    size_t eliminationCount = 0;
+    /** Cells filled by the search (decisions and forced values), `placedCount` of them. */
+    size_t placedCount = 0;
+    /** Decisions of the search, `trailSize` of them. */
+    Frame *trail = nullptr;
+    size_t trailSize = 0;
+    /** Steps not published yet. */
+    ProgressStep *pending = nullptr;
+    ///@}
+    /** Set by `requestStop()`, polled by the search loop. */
+    std::atomic<bool> stopRequested{false};
+
+    /** True if the workspace holds a stopped search that `resume()` can continue. */
+    bool suspended = false;
+    /** Called by the search at each solution, if set; false pauses the search. */
+    const SolutionCallback *solutionVisitor = nullptr;
+    /** True if the stopped search is an enumeration that `nextSolution()` continues. */
+    bool enumerating = false;
+    /** How the stopped search was running. */
+    struct Suspension {
+        unsigned long limit = 0;
+        /** Solutions found before the stop. */
+        unsigned long found = 0;
+        /** false if the last placement failed and the next alternative is due. */
+        bool consistent = false;
+        bool warm = false;
+        /** Whether the search recorded progress (a `solve()`). */
+        bool record = false;
+    } suspension;
+
+    /** Counters of the current (or last) search. */
+    SearchStatistics stats;
+    /** Dead partial grids, shared by every search at this dimension (see `setDeadStateTable()`). */
+    DeadStateTable deadStates;
+    /** Heuristics of the backtracking search. */
+    SearchOptions options;
+
+    /** @name Checkpointing (see `setCheckpointing()`) */
+    ///@{
+    std::unique_ptr<CheckpointWriter> checkpointWriter;
+    std::chrono::milliseconds checkpointInterval{0};
+    /** Reused for every checkpoint; swapped with the writer's spare buffer. */
+    std::vector<uint8_t> checkpointBuffer;
+    ///@}
+    /** Search trace (see `setTracing()`), null when tracing is off. */
+    std::unique_ptr<SearchTraceWriter> traceWriter;
+
+    /**
+     * @brief Writes the solver state, with a search in progress if `search` is set.
+     * @param out Buffer the state is appended to.
+     * @param search The stopped (or running) search to store, or null.
+     * @param statistics Counters to store with the search.
+     */
+    void writeState(std::vector<uint8_t> &out, const Suspension *search, const SearchStatistics &statistics) const;
+
+    /**
+     * @brief Hands a checkpoint of the current state to the writer thread.
+     * @param search How the search is running.
+     * @param running Time spent by the running search so far (not yet in `stats`).
+     * @param inSearch false to store the puzzle and solution only (a finished search).
+     */
+    void writeCheckpoint(const Suspension &search, std::chrono::nanoseconds running, bool inSearch = true);
+
+    /**
+     * @brief Publishes the first `count` pending steps, with one lock (or to the listener).
+     * @return 0, the new number of pending steps.
+     */
+    size_t flushProgress(size_t count);
 
  /** Mutex protecting access to the `coords` progress buffer. */
     mutable std::mutex coordsMutex;
     /** FIFO list of coordinates set during solving, for UI progress display. */
-    std::vector<std::pair<unsigned short, unsigned short>> coords;
+    std::vector<ProgressStep> coords;
+    /** Whether `solve()` records its steps. */
+    std::atomic<bool> progressEnabled{true};
+    /** If set, receives the steps in place of `coords`. */
+    ProgressListener progressListener;
 	
-    /** Non-copyable to avoid double-free of the internal grid. */
-    SudokuSolverAlgorithm(const SudokuSolverAlgorithm&) = delete;
-    /** Non-copyable to avoid double-free of the internal grid. */
-    SudokuSolverAlgorithm& operator=(const SudokuSolverAlgorithm&) = delete;
+    /** @brief `solution`, ready to be overwritten: replaced by a private copy if it is shared. */
+    unsigned short *writableSolution();
+    /** @brief Copies the puzzle state of a solver of the same dimension. */
+    void copyFrom(const SudokuSolverAlgorithm &other);
+
+public:
+    /**
+     * @brief Copies the puzzle: grid, clues and cached solution (shared until written).
+     *
+     * The copy gets its own arena and an empty progress buffer; listeners and
+     * stop requests are not copied. Do not copy a solver while it is solving.
+     */
+    SudokuSolverAlgorithm(const SudokuSolverAlgorithm &other);
+    /** @brief Same as the copy constructor, reusing this solver's memory when it fits. */
+    SudokuSolverAlgorithm& operator=(const SudokuSolverAlgorithm &other);
 };
 
 
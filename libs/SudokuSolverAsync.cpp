@@ -0,0 +1,130 @@
+#include "SudokuSolverAsync.h"
+
+#include <algorithm>
+#include <utility>
+
+SolverExecutor::SolverExecutor(unsigned count) {
+    if (count == 0)
+        count = std::max(1u, std::thread::hardware_concurrency());
+
+    threads.reserve(count);
+    for (unsigned i = 0; i < count; i++)
+        threads.emplace_back([this] { work(); });
+}
+
+SolverExecutor::~SolverExecutor() {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (std::thread &t : threads)
+        t.join();
+}
+
+void SolverExecutor::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+SolverExecutor& SolverExecutor::shared() {
+    static SolverExecutor executor;
+    return executor;
+}
+
+void SolverExecutor::work() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+            // In chiusura si svuota comunque la coda: nessun future resta appeso
+            if (tasks.empty())
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+bool SolveFuture::ready() const {
+    std::lock_guard<std::mutex> guard(state->mutex);
+    return state->done;
+}
+
+bool SolveFuture::get() const {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [this] { return state->done; });
+
+    if (state->error)
+        std::rethrow_exception(state->error);
+    return state->result;
+}
+
+void SolveFuture::cancel() const {
+    // A solve finito lo stop resterebbe sul solver e fermerebbe il prossimo
+    std::lock_guard<std::mutex> guard(state->mutex);
+    if (!state->done)
+        state->solver->requestStop();
+}
+
+bool SolveFuture::await_suspend(std::coroutine_handle<> continuation) const {
+    std::lock_guard<std::mutex> guard(state->mutex);
+
+    // Già finito: la coroutine prosegue senza sospendersi
+    if (state->done)
+        return false;
+
+    state->continuation = continuation;
+    return true;
+}
+
+void SolveFuture::State::complete(bool ok, std::exception_ptr e) {
+    std::coroutine_handle<> resume;
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        // Un cancel() arrivato tra la fine di solve() e questo punto non deve restare pendente
+        solver->clearStopRequest();
+        done = true;
+        result = ok;
+        error = std::move(e);
+        resume = std::exchange(continuation, {});
+    }
+    finished.notify_all();
+
+    // La coroutine riprende su questo thread, fuori dal lock
+    if (resume)
+        resume.resume();
+}
+
+SolveFuture solveAsync(std::shared_ptr<SudokuSolverAlgorithm> solver,
+                       SudokuSolverAlgorithm::ProgressListener onProgress,
+                       SolverExecutor &executor) {
+    auto state = std::make_shared<SolveFuture::State>();
+    state->solver = std::move(solver);
+
+    executor.post([state, onProgress = std::move(onProgress)]() mutable {
+        SudokuSolverAlgorithm &solver = *state->solver;
+
+        bool ok = false;
+        std::exception_ptr error;
+        try {
+            solver.setProgressListener(std::move(onProgress));
+            ok = solver.solve();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        solver.setProgressListener({});
+
+        state->complete(ok, std::move(error));
+    });
+
+    return SolveFuture(state);
+}
@@ -0,0 +1,156 @@
+#ifndef SUDOKUSOLVERASYNC_LIBRARY_H
+#define SUDOKUSOLVERASYNC_LIBRARY_H
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SudokuSolverAlgorithm.h"
+
+/**
+ * @file SudokuSolverAsync.h
+ * @brief Asynchronous solves on a shared thread pool, without any UI framework.
+ *
+ * `solveAsync()` queues a solve on a `SolverExecutor` and returns a
+ * `SolveFuture` at once. The future can be waited on, polled, cancelled or
+ * `co_await`ed from a C++20 coroutine. Many solves share the executor's
+ * threads: a host running thousands of puzzles needs no thread per solve.
+ *
+ * Example:
+ * @code
+ * auto solver = std::make_shared<SudokuSolverAlgorithm>(9);
+ * // ... insert the clues ...
+ * SolveFuture f = solveAsync(solver, [](const auto &steps) { ... });
+ * bool ok = f.get();              // or: bool ok = co_await f;
+ * @endcode
+ */
+
+/**
+ * @brief Fixed pool of threads running queued tasks in FIFO order.
+ */
+class SUDOKUSOLVER_EXPORT SolverExecutor {
+public:
+    /**
+     * @brief Starts the threads.
+     * @param threads Number of threads; 0 uses one per hardware thread.
+     */
+    explicit SolverExecutor(unsigned threads = 0);
+
+    /**
+     * @brief Runs the tasks still queued, then joins the threads.
+     */
+    ~SolverExecutor();
+
+    SolverExecutor(const SolverExecutor&) = delete;
+    SolverExecutor& operator=(const SolverExecutor&) = delete;
+
+    /**
+     * @brief Queues a task; it runs on one of the pool threads.
+     */
+    void post(std::function<void()> task);
+
+    /** @brief Number of threads of the pool. */
+    [[nodiscard]] unsigned threadCount() const { return static_cast<unsigned>(threads.size()); }
+
+    /**
+     * @brief Process-wide executor with one thread per hardware thread, created on first use.
+     */
+    static SolverExecutor& shared();
+
+private:
+    /** @brief Loop of each pool thread. */
+    void work();
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::function<void()>> tasks;
+    bool stopping = false;
+    std::vector<std::thread> threads;
+};
+
+/**
+ * @brief Result of a solve that may still be running.
+ *
+ * Copies share the same solve. At most one coroutine may `co_await` it; the
+ * coroutine is resumed on the executor thread that finished the solve.
+ */
+class SUDOKUSOLVER_EXPORT SolveFuture {
+public:
+    /** @brief true once the solve has ended (solved, failed or cancelled). */
+    [[nodiscard]] bool ready() const;
+
+    /**
+     * @brief Waits for the solve and returns its result.
+     * @return true if the puzzle was solved; false if it has no solution or was cancelled.
+     */
+    bool get() const;
+
+    /**
+     * @brief Waits for at most a given time.
+     * @return true if the solve has ended.
+     */
+    template <class Rep, class Period>
+    bool waitFor(const std::chrono::duration<Rep, Period> &timeout) const {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        return state->finished.wait_for(lock, timeout, [this] { return state->done; });
+    }
+
+    /**
+     * @brief Asks the solve to stop; a queued solve returns without searching.
+     *
+     * Cancelling a solve that has already ended does nothing: the shared
+     * solver is not left with a pending stop.
+     */
+    void cancel() const;
+
+    /** @name Coroutine awaiter (`co_await future` yields the result of `get()`) */
+    ///@{
+    [[nodiscard]] bool await_ready() const { return ready(); }
+    bool await_suspend(std::coroutine_handle<> continuation) const;
+    bool await_resume() const { return get(); }
+    ///@}
+
+private:
+    friend SolveFuture solveAsync(std::shared_ptr<SudokuSolverAlgorithm>,
+                                  SudokuSolverAlgorithm::ProgressListener,
+                                  SolverExecutor&);
+
+    /** State shared by the future and the running task. */
+    struct State {
+        mutable std::mutex mutex;
+        std::condition_variable finished;
+        bool done = false;
+        bool result = false;
+        std::exception_ptr error;
+        std::coroutine_handle<> continuation;
+        std::shared_ptr<SudokuSolverAlgorithm> solver;
+
+        /** @brief Stores the outcome, wakes the waiters and resumes the awaiting coroutine. */
+        void complete(bool ok, std::exception_ptr e);
+    };
+
+    explicit SolveFuture(std::shared_ptr<State> s) : state(std::move(s)) {}
+
+    std::shared_ptr<State> state;
+};
+
+/**
+ * @brief Queues `solver->solve()` on an executor.
+ * @param solver Solver with the clues inserted; kept alive until the solve ends.
+ *        It must not be used by anyone else meanwhile.
+ * @param onProgress Optional callback receiving the steps in batches, on the
+ *        executor thread; while it is set the solver's progress buffer stays empty.
+ * @param executor Executor running the solve.
+ * @return A future for the result.
+ */
+SUDOKUSOLVER_EXPORT SolveFuture solveAsync(std::shared_ptr<SudokuSolverAlgorithm> solver,
+                                           SudokuSolverAlgorithm::ProgressListener onProgress = {},
+                                           SolverExecutor &executor = SolverExecutor::shared());
+
+#endif // SUDOKUSOLVERASYNC_LIBRARY_H
@@ -0,0 +1,262 @@
+#include "SudokuSolverC.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "SudokuSolverAlgorithm.h"
+
+// Le celle del chiamante si passano al solver così come sono, senza conversioni
+static_assert(std::is_same_v<uint16_t, unsigned short>, "cells are passed to the solver without conversion");
+
+struct SudokuSolver {
+    explicit SudokuSolver(unsigned short dimension) : main(dimension) {
+        main.setProgressRecording(false);
+    }
+
+    SudokuSolverAlgorithm main;
+    SudokuSolverAlgorithm::Engine engine = SudokuSolverAlgorithm::Engine::Backtracking;
+
+    /** Set by `sudoku_request_stop()`, cleared when the running call returns. */
+    std::atomic<bool> stop{false};
+    /** Guards `running` and `workers` against `sudoku_request_stop()`. */
+    std::mutex mutex;
+    bool running = false;
+    /** Solvers of the batch threads, kept from one batch to the next. */
+    std::vector<std::unique_ptr<SudokuSolverAlgorithm>> workers;
+};
+
+namespace {
+
+/** Una chiamata in corso sul solver: la richiesta di stop la raggiunge solo mentre è attiva */
+class Call {
+public:
+    explicit Call(SudokuSolver &handle) : handle(handle) {
+        const std::lock_guard<std::mutex> lock(handle.mutex);
+        handle.running = true;
+        // Stop chiesto mentre non girava nulla: questa chiamata si ferma subito
+        early = handle.stop.load();
+    }
+
+    ~Call() {
+        const std::lock_guard<std::mutex> lock(handle.mutex);
+        handle.running = false;
+        if (handle.stop.exchange(false)) {
+            // Uno stop arrivato a chiamata finita resterebbe pendente sui solver
+            handle.main.clearStopRequest();
+            for (const auto &worker : handle.workers)
+                worker->clearStopRequest();
+        }
+    }
+
+    Call(const Call&) = delete;
+    Call& operator=(const Call&) = delete;
+
+    [[nodiscard]] bool stoppedEarly() const { return early; }
+
+private:
+    SudokuSolver &handle;
+    bool early = false;
+};
+
+size_t cellCount(const SudokuSolver &handle) {
+    const size_t dimension = handle.main.size();
+    return dimension * dimension;
+}
+
+/** Nessuna eccezione attraversa l'interfaccia C */
+template <class Function>
+SudokuStatus guarded(Function &&function) {
+    try {
+        return function();
+    } catch (const std::bad_alloc &) {
+        return SUDOKU_OUT_OF_MEMORY;
+    } catch (...) {
+        return SUDOKU_INTERNAL_ERROR;
+    }
+}
+
+/** Risolve una griglia sul posto con un solver qualsiasi dell'handle */
+SudokuStatus solveInPlace(SudokuSolver &handle, SudokuSolverAlgorithm &solver, uint16_t *cells, size_t count) {
+    if (!solver.load({cells, count}).empty())
+        return SUDOKU_CONFLICT;
+    if (solver.solve(handle.engine)) {
+        solver.store({cells, count});
+        return SUDOKU_OK;
+    }
+    return handle.stop.load() ? SUDOKU_STOPPED : SUDOKU_UNSOLVABLE;
+}
+
+}
+
+uint32_t sudoku_abi_version(void) {
+    return SUDOKU_ABI_VERSION;
+}
+
+const char *sudoku_status_string(SudokuStatus status) {
+    switch (status) {
+    case SUDOKU_OK: return "ok";
+    case SUDOKU_UNSOLVABLE: return "no solution";
+    case SUDOKU_STOPPED: return "stopped";
+    case SUDOKU_INVALID_ARGUMENT: return "invalid argument";
+    case SUDOKU_CONFLICT: return "conflicting values";
+    case SUDOKU_OUT_OF_MEMORY: return "out of memory";
+    case SUDOKU_INTERNAL_ERROR: return "internal error";
+    }
+    return "unknown status";
+}
+
+SudokuStatus sudoku_create(uint16_t dimension, SudokuSolver **out) {
+    if (!out)
+        return SUDOKU_INVALID_ARGUMENT;
+    *out = nullptr;
+
+    const auto block = static_cast<uint16_t>(std::lround(std::sqrt(static_cast<double>(dimension))));
+    if (dimension == 0 || dimension > 64 || block * block != dimension)
+        return SUDOKU_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        *out = new SudokuSolver(dimension);
+        return SUDOKU_OK;
+    });
+}
+
+void sudoku_destroy(SudokuSolver *solver) {
+    delete solver;
+}
+
+uint16_t sudoku_dimension(const SudokuSolver *solver) {
+    return solver ? solver->main.size() : 0;
+}
+
+SudokuStatus sudoku_set_engine(SudokuSolver *solver, SudokuEngine engine) {
+    if (!solver || (engine != SUDOKU_ENGINE_BACKTRACKING && engine != SUDOKU_ENGINE_SAT))
+        return SUDOKU_INVALID_ARGUMENT;
+    solver->engine = engine == SUDOKU_ENGINE_SAT ? SudokuSolverAlgorithm::Engine::Sat
+                                                 : SudokuSolverAlgorithm::Engine::Backtracking;
+    return SUDOKU_OK;
+}
+
+SudokuStatus sudoku_solve(SudokuSolver *solver, uint16_t *cells, size_t count) {
+    if (!solver || !cells || count != cellCount(*solver))
+        return SUDOKU_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        const Call call(*solver);
+        if (call.stoppedEarly())
+            return SUDOKU_STOPPED;
+        return solveInPlace(*solver, solver->main, cells, count);
+    });
+}
+
+SudokuStatus sudoku_count_solutions(SudokuSolver *solver, const uint16_t *cells, size_t count,
+                                    uint64_t limit, uint64_t *found) {
+    if (!solver || !cells || !found || count != cellCount(*solver))
+        return SUDOKU_INVALID_ARGUMENT;
+    *found = 0;
+
+    return guarded([&] {
+        const Call call(*solver);
+        if (call.stoppedEarly())
+            return SUDOKU_STOPPED;
+        if (!solver->main.load({cells, count}).empty())
+            return SUDOKU_CONFLICT;
+
+        *found = solver->main.countSolutions(static_cast<unsigned long>(std::min<uint64_t>(limit, ULONG_MAX)), solver->engine);
+        if (solver->stop.load())
+            return SUDOKU_STOPPED;
+        return *found > 0 ? SUDOKU_OK : SUDOKU_UNSOLVABLE;
+    });
+}
+
+SudokuStatus sudoku_validate(SudokuSolver *solver, const uint16_t *cells, size_t count,
+                             size_t *conflicts, size_t capacity, size_t *conflictCount) {
+    if (!solver || !cells || !conflictCount || (capacity > 0 && !conflicts) || count != cellCount(*solver))
+        return SUDOKU_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        const std::vector<SudokuSolverAlgorithm::Conflict> found = solver->main.load({cells, count});
+        const size_t dimension = solver->main.size();
+        for (size_t i = 0; i < found.size() && i < capacity; i++)
+            conflicts[i] = found[i].row * dimension + found[i].column;
+        *conflictCount = found.size();
+        return found.empty() ? SUDOKU_OK : SUDOKU_CONFLICT;
+    });
+}
+
+SudokuStatus sudoku_solve_batch(SudokuSolver *solver, uint16_t *cells, size_t puzzles,
+                                SudokuStatus *statuses, unsigned threads) {
+    if (!solver || (!cells && puzzles > 0))
+        return SUDOKU_INVALID_ARGUMENT;
+    const size_t count = cellCount(*solver);
+
+    return guarded([&] {
+        const Call call(*solver);
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, puzzles)));
+        {
+            const std::lock_guard<std::mutex> lock(solver->mutex);
+            while (solver->workers.size() < threads) {
+                solver->workers.push_back(std::make_unique<SudokuSolverAlgorithm>(solver->main.size()));
+                solver->workers.back()->setProgressRecording(false);
+            }
+        }
+
+        // Il risultato è il primo errore nell'ordine delle griglie, qualunque thread lo trovi
+        std::atomic<size_t> next{0};
+        std::mutex failureMutex;
+        size_t firstFailure = puzzles;
+        SudokuStatus result = SUDOKU_OK;
+
+        auto work = [&](SudokuSolverAlgorithm &worker) {
+            for (size_t i = next++; i < puzzles; i = next++) {
+                SudokuStatus status = SUDOKU_STOPPED;
+                if (!call.stoppedEarly() && !solver->stop.load()) {
+                    // Griglie indipendenti: la soluzione della precedente non serve da partenza
+                    worker.clean();
+                    status = guarded([&] { return solveInPlace(*solver, worker, cells + i * count, count); });
+                }
+                if (statuses)
+                    statuses[i] = status;
+                if (status != SUDOKU_OK) {
+                    const std::lock_guard<std::mutex> lock(failureMutex);
+                    if (i < firstFailure) {
+                        firstFailure = i;
+                        result = status;
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (unsigned t = 1; t < threads; t++)
+            pool.emplace_back(work, std::ref(*solver->workers[t]));
+        work(*solver->workers[0]);
+        for (std::thread &thread : pool)
+            thread.join();
+
+        return call.stoppedEarly() ? SUDOKU_STOPPED : result;
+    });
+}
+
+void sudoku_request_stop(SudokuSolver *solver) {
+    if (!solver)
+        return;
+
+    const std::lock_guard<std::mutex> lock(solver->mutex);
+    solver->stop.store(true);
+    if (!solver->running)
+        return;
+    solver->main.requestStop();
+    for (const auto &worker : solver->workers)
+        worker->requestStop();
+}
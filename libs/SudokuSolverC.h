@@ -0,0 +1,135 @@
+#ifndef SUDOKUSOLVERC_LIBRARY_H
+#define SUDOKUSOLVERC_LIBRARY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SudokuSolverExport.h"
+
+/**
+ * @file SudokuSolverC.h
+ * @brief Stable C API of the solver, for hosts written in other languages.
+ *
+ * The solver is an opaque handle; every call takes caller-owned buffers of
+ * cells, so a host passes its own memory and nothing is marshalled:
+ * - a grid is `dimension * dimension` `uint16_t` values, row-major, 0 for an
+ *   empty cell and `v` in [1, dimension] for a value;
+ * - solves work in place: the buffer holds the clues on entry and the
+ *   solution on success, and is left untouched on failure;
+ * - batches are that many grids back to back in one buffer.
+ *
+ * Every call returns a SudokuStatus; nothing is printed and no C++ exception
+ * crosses the API. A handle must not be used by two threads at once, except
+ * for `sudoku_request_stop()`, which may be called from any thread.
+ *
+ * The layout of these declarations only changes with `SUDOKU_ABI_VERSION`.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Version of this API; `sudoku_abi_version()` returns the library's. */
+#define SUDOKU_ABI_VERSION 1
+
+/** Opaque solver handle. */
+typedef struct SudokuSolver SudokuSolver;
+
+/** Result of a call; negative values are errors. */
+typedef enum SudokuStatus {
+    /** The call succeeded (for a solve: the buffer holds the solution). */
+    SUDOKU_OK = 0,
+    /** The clues are valid but have no solution. */
+    SUDOKU_UNSOLVABLE = 1,
+    /** `sudoku_request_stop()` stopped the call before it was done. */
+    SUDOKU_STOPPED = 2,
+    /** A null pointer, a buffer of the wrong size or an unsupported dimension. */
+    SUDOKU_INVALID_ARGUMENT = -1,
+    /** A value is out of range or repeats in a row, column or block. */
+    SUDOKU_CONFLICT = -2,
+    /** Memory could not be allocated. */
+    SUDOKU_OUT_OF_MEMORY = -3,
+    /** Unexpected failure inside the library. */
+    SUDOKU_INTERNAL_ERROR = -4
+} SudokuStatus;
+
+/** Search engine (see SudokuSolverAlgorithm::Engine). */
+typedef enum SudokuEngine {
+    SUDOKU_ENGINE_BACKTRACKING = 0,
+    SUDOKU_ENGINE_SAT = 1
+} SudokuEngine;
+
+/** @brief `SUDOKU_ABI_VERSION` the library was built with. */
+SUDOKUSOLVER_EXPORT uint32_t sudoku_abi_version(void);
+
+/** @brief Short English description of a status, never null. */
+SUDOKUSOLVER_EXPORT const char *sudoku_status_string(SudokuStatus status);
+
+/**
+ * @brief Creates a solver.
+ * @param dimension Grid size: a perfect square from 1 to 64 (e.g. 9 for 9x9).
+ * @param out Receives the handle; null on failure.
+ */
+SUDOKUSOLVER_EXPORT SudokuStatus sudoku_create(uint16_t dimension, SudokuSolver **out);
+
+/** @brief Frees a solver; null is ignored. */
+SUDOKUSOLVER_EXPORT void sudoku_destroy(SudokuSolver *solver);
+
+/** @brief Grid size of a solver, 0 for null. */
+SUDOKUSOLVER_EXPORT uint16_t sudoku_dimension(const SudokuSolver *solver);
+
+/** @brief Engine of the next solves (backtracking by default). */
+SUDOKUSOLVER_EXPORT SudokuStatus sudoku_set_engine(SudokuSolver *solver, SudokuEngine engine);
+
+/**
+ * @brief Solves a grid in place.
+ * @param cells Clues on entry, the solution on SUDOKU_OK.
+ * @param count Number of cells in `cells`: `dimension * dimension`.
+ */
+SUDOKUSOLVER_EXPORT SudokuStatus sudoku_solve(SudokuSolver *solver, uint16_t *cells, size_t count);
+
+/**
+ * @brief Counts the solutions of a grid, up to a limit.
+ * @param found Receives the number found (at most `limit`); 2 of 2 means "not unique".
+ */
+SUDOKUSOLVER_EXPORT SudokuStatus sudoku_count_solutions(SudokuSolver *solver, const uint16_t *cells, size_t count,
+                                                        uint64_t limit, uint64_t *found);
+
+/**
+ * @brief Lists the cells that break the rules, without solving.
+ * @param conflicts Receives up to `capacity` row-major cell indices; may be null if `capacity` is 0.
+ * @param conflictCount Receives the total number of conflicting cells, which may exceed `capacity`.
+ * @return SUDOKU_OK if the grid is valid, SUDOKU_CONFLICT otherwise.
+ */
+SUDOKUSOLVER_EXPORT SudokuStatus sudoku_validate(SudokuSolver *solver, const uint16_t *cells, size_t count,
+                                                 size_t *conflicts, size_t capacity, size_t *conflictCount);
+
+/**
+ * @brief Solves many grids in place.
+ * @param cells `puzzles` grids back to back, each solved in place.
+ * @param puzzles Number of grids.
+ * @param statuses Receives the status of each grid; may be null.
+ * @param threads Worker threads; 0 uses one per hardware thread, 1 solves on the calling thread.
+ * @return SUDOKU_OK if every grid was solved, otherwise the first failing status
+ *         in input order (SUDOKU_STOPPED if the batch was stopped).
+ *
+ * Each thread keeps its own solver, so after the first grids the batch
+ * allocates nothing. Grids not reached after a stop are reported as stopped.
+ */
+SUDOKUSOLVER_EXPORT SudokuStatus sudoku_solve_batch(SudokuSolver *solver, uint16_t *cells, size_t puzzles,
+                                                    SudokuStatus *statuses, unsigned threads);
+
+/**
+ * @brief Asks a running call on this handle to stop (thread-safe).
+ *
+ * The call returns SUDOKU_STOPPED as soon as possible. The request is
+ * cleared when that call returns; if nothing is running, the next call stops
+ * immediately.
+ */
+SUDOKUSOLVER_EXPORT void sudoku_request_stop(SudokuSolver *solver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SUDOKUSOLVERC_LIBRARY_H
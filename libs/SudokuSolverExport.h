@@ -0,0 +1,25 @@
+#ifndef SUDOKUSOLVEREXPORT_LIBRARY_H
+#define SUDOKUSOLVEREXPORT_LIBRARY_H
+
+/**
+ * @file SudokuSolverExport.h
+ * @brief Marks the symbols exported by the shared library.
+ *
+ * The library is built with hidden visibility (`SUDOKUSOLVER_BUILD` defined),
+ * so only what carries `SUDOKUSOLVER_EXPORT` is visible to other modules: the
+ * C API of SudokuSolverC.h and the public C++ classes. Internal classes such
+ * as SatSolver and CheckpointWriter stay private to the library.
+ * Plain C, so it can be included from SudokuSolverC.h.
+ */
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+#  ifdef SUDOKUSOLVER_BUILD
+#    define SUDOKUSOLVER_EXPORT __declspec(dllexport)
+#  else
+#    define SUDOKUSOLVER_EXPORT __declspec(dllimport)
+#  endif
+#else
+#  define SUDOKUSOLVER_EXPORT __attribute__((visibility("default")))
+#endif
+
+#endif // SUDOKUSOLVEREXPORT_LIBRARY_H
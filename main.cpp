@@ -6,9 +6,14 @@
 #include <QDir>
 #include <QDebug>
 #include <QStandardPaths>
+#include <QFile>
+#include <QTextStream>
+#include <cctype>
+#include <cmath>
 
 #include "AppManager.h"
 #include "SingleIstance.h"
+#include "libs/SudokuSolverAlgorithm.h"
 
 void installLanguage(const QApplication*a) {
     // Nome dell'applicazione (deve coincidere con i file .qm)
@@ -86,6 +91,79 @@ void installLanguage(const QApplication*a) {
     }
 }
 
+/*
+ * Istanza secondaria: consegna all'istanza già aperta la griglia di ogni file ("-" per lo standard input)
+ * e stampa le soluzioni. Senza file chiede solo di portarne in primo piano la finestra.
+ * Restituisce 0 se ogni griglia è stata risolta.
+ */
+int submitToPrimary(SingleInstance &instance, const QStringList &files) {
+    if (files.isEmpty()) {
+        instance.requestActivation();
+        return 0;
+    }
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    int failures = 0;
+
+    for (const QString &path : files) {
+        QFile file(path);
+        const bool opened = path == "-" ? file.open(stdin, QIODevice::ReadOnly) : file.open(QIODevice::ReadOnly);
+        if (!opened) {
+            err << path << ": " << file.errorString() << Qt::endl;
+            failures++;
+            continue;
+        }
+
+        // Stessi separatori di loadFromString; la dimensione segue dal numero di simboli (81 per il 9x9)
+        QByteArray symbols;
+        for (const char symbol : file.readAll()) {
+            if (!std::isspace(static_cast<unsigned char>(symbol)) && symbol != '|' && symbol != '+' && symbol != '-')
+                symbols.append(symbol);
+        }
+        const auto dimension = static_cast<quint16>(std::lround(std::sqrt(static_cast<double>(symbols.size()))));
+        const auto block = static_cast<quint16>(std::lround(std::sqrt(static_cast<double>(dimension))));
+        if (dimension == 0 || dimension > SingleInstance::maxDimension
+            || static_cast<qsizetype>(dimension) * dimension != symbols.size() || block * block != dimension) {
+            err << path << ": griglia non valida" << Qt::endl;
+            failures++;
+            continue;
+        }
+
+        QVector<quint16> cells;
+        cells.reserve(symbols.size());
+        for (const char symbol : symbols)
+            cells.append(SudokuSolverAlgorithm::valueFor(symbol, dimension));
+
+        const SingleInstance::JobResult result = instance.submit(cells, dimension);
+        switch (result.status) {
+        case SingleInstance::JobStatus::Solved:
+            for (int row = 0; row < dimension; row++) {
+                for (int column = 0; column < dimension; column++)
+                    out << SudokuSolverAlgorithm::symbolFor(result.cells[row * dimension + column]);
+                out << '\n';
+            }
+            out << Qt::endl;
+            continue;
+        case SingleInstance::JobStatus::Unsolvable:
+            err << path << ": nessuna soluzione" << Qt::endl;
+            break;
+        case SingleInstance::JobStatus::Invalid:
+            err << path << ": griglia non valida" << Qt::endl;
+            break;
+        case SingleInstance::JobStatus::TimedOut:
+            err << path << ": nessuna risposta dall'istanza aperta" << Qt::endl;
+            break;
+        case SingleInstance::JobStatus::Unavailable:
+            err << path << ": l'istanza aperta non accetta griglie" << Qt::endl;
+            break;
+        }
+        failures++;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
 int main(int argc, char *argv[])
 {
     const QApplication a(argc, argv);
@@ -98,9 +176,10 @@ int main(int argc, char *argv[])
 
     SingleInstance instance(appId);
     if (!instance.isPrimaryInstance())
-        return 0;
+        return submitToPrimary(instance, QApplication::arguments().mid(1));
 
     AppManager manager;
+    QObject::connect(&instance, &SingleInstance::activationRequested, &manager, &AppManager::activate);
     manager.start();
 
     return QApplication::exec();
@@ -1,28 +1,35 @@
 #include "mainwindow.h"
-#include "solverworker.h"
+#include "solverservice.h"
 #include "ui_mainwindow.h"
 #include "StartupDialog.h"
 
 #include <QPushButton>
-#include <QLineEdit>
-#include <QRegularExpressionValidator>
 #include <QTimer>
 #include <QMessageBox>
 #include <QResizeEvent>
-#include <QThread>
 #include <QCloseEvent>
+#include <QStatusBar>
+#include <QSignalBlocker>
+#include <QScreen>
+#include <QActionGroup>
+#include <QBitArray>
+#include <QDataStream>
+#include <algorithm>
+
+namespace {
+    // Intestazione del file di sessione ("SSES") e sua versione
+    constexpr quint32 sessionMagic = 0x53534553;
+    constexpr quint8 sessionVersion = 1;
+}
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , solver(nullptr)
 {
 
     // Qua probabilmente ci devi mettere solo le cose fisse
     ui->setupUi(this);
 
-    font = QFont("Arial", 22, QFont::Bold);
-
     setWindowTitle("SudokuSolver");
     setMinimumSize(600, 700);
     resize(600, 700);
@@ -34,7 +41,7 @@ MainWindow::MainWindow(QWidget *parent)
     mainLayout->setContentsMargins(0, 0, 0, 0);
     mainLayout->setSpacing(0);
 
-    windowContent();
+    // Il contenuto dipende dalla dimensione: viene creato da initializeForMode
 
     // Usiamo QTimer per forzare un aggiornamento del layout all'avvio
     QTimer::singleShot(0, this, [this](){
@@ -45,16 +52,34 @@ MainWindow::MainWindow(QWidget *parent)
     });
 
     setupMenu();
+
+    // Gli indizi sono "stabili" dopo mezzo secondo senza modifiche
+    clueTimer = new QTimer(this);
+    clueTimer->setSingleShot(true);
+    clueTimer->setInterval(500);
+    connect(clueTimer, &QTimer::timeout, this, &MainWindow::startSpeculativeSolve);
+
+    // Thread di risoluzione avviati una volta sola, per tutta la vita della finestra
+    service = new SolverService(2, this);
+    connect(service, &SolverService::finished, this, &MainWindow::onJobFinished);
+
+    // Salvataggio automatico: ogni pochi secondi, solo se qualcosa è cambiato
+    autosaveTimer = new QTimer(this);
+    autosaveTimer->setInterval(3000);
+    connect(autosaveTimer, &QTimer::timeout, this, &MainWindow::autosave);
+    autosaveTimer->start();
 }
 
 MainWindow::~MainWindow()
 {
-    delete solver;
     delete ui;
 }
 
 void MainWindow::initializeForMode(const int & mode) {
-    dim = mode == 1 ? 9 : 16;
+    // Il lato del blocco è mode + 2: 9x9, 16x16, 25x25, 36x36
+    const unsigned short block = static_cast<unsigned short>(mode + 2);
+    dim = block * block;
+    windowContent();
 }
 
 void MainWindow::windowContent() {
@@ -66,17 +91,13 @@ void MainWindow::windowContent() {
         QApplication::quit();
     }*/
 
-    solver = new SudokuSolverAlgorithm(dim);
-
-    cells.resize(dim);
-    for(unsigned short i=0; i<dim; ++i)
-        cells[i].resize(dim);
+    solver = std::make_shared<SudokuSolverAlgorithm>(dim);
 
-    gridWidget = setupGrid(dim);
+    gridView = setupGrid(dim);
     optionPanel = setupOptionsPanel(dim);
 
     // Griglia sopra (4 parti), Opzioni sotto (2 parti)
-    mainLayout->addWidget(gridWidget, 4);
+    mainLayout->addWidget(gridView, 4);
     mainLayout->addWidget(optionPanel, 2);
 }
 
@@ -91,30 +112,101 @@ void MainWindow::setupMenu() {
     fileMenu->addSeparator();
     fileMenu->addAction(exitAction);
 
+    QMenu *editMenu = menuBar()->addMenu("Modifica");
+    auto *undoAction = editMenu->addAction("Annulla");
+    undoAction->setShortcut(QKeySequence::Undo);
+    auto *redoAction = editMenu->addAction("Ripeti");
+    redoAction->setShortcut(QKeySequence::Redo);
+
     QMenu *gameMenu = menuBar()->addMenu("Gioco");
     auto *checkAction = new QAction("Controlla", this);
     auto *hintAction = new QAction("Suggerimento", this);
+    auto *fillForcedAction = new QAction("Riempi celle forzate", this);
+
+    lockCluesAction = new QAction("Blocca indizi", this);
+    lockCluesAction->setCheckable(true);
 
+    gameMenu->addAction(lockCluesAction);
+    gameMenu->addSeparator();
     gameMenu->addAction(checkAction);
     gameMenu->addAction(hintAction);
+    gameMenu->addAction(fillForcedAction);
+
+    // Animazione della risoluzione
+    QMenu *viewMenu = menuBar()->addMenu("Visualizza");
+    auto *modeGroup = new QActionGroup(this);
+
+    const QList<QPair<QString, ProgressMode>> modes = {
+        {"Animazione in tempo reale", ProgressMode::Realtime},
+        {"Velocità massima", ProgressMode::MaxSpeed},
+        {"Replay", ProgressMode::Replay},
+    };
+    for (const auto &[label, mode] : modes) {
+        auto *action = viewMenu->addAction(label);
+        action->setCheckable(true);
+        action->setChecked(mode == progressMode);
+        modeGroup->addAction(action);
+        connect(action, &QAction::triggered, this, [this, mode = mode](){ progressMode = mode; });
+    }
+
+    QMenu *speedMenu = viewMenu->addMenu("Velocità replay");
+    auto *speedGroup = new QActionGroup(this);
+    for (int speed : {10, 50, 200, 1000, 10000}) {
+        auto *action = speedMenu->addAction(QString("%1 passi/s").arg(speed));
+        action->setCheckable(true);
+        action->setChecked(speed == replaySpeed);
+        speedGroup->addAction(action);
+        connect(action, &QAction::triggered, this, [this, speed](){ replaySpeed = speed; });
+    }
+
+    // Passi dell'ultima risoluzione registrata
+    viewMenu->addSeparator();
+    const QList<QPair<QString, QPair<QKeySequence, long long>>> steps = {
+        {"Passo indietro", {QKeySequence(Qt::ALT | Qt::Key_Left), -1}},
+        {"Passo avanti", {QKeySequence(Qt::ALT | Qt::Key_Right), 1}},
+        {"Indietro di 1000 passi", {QKeySequence(Qt::ALT | Qt::Key_PageUp), -1000}},
+        {"Avanti di 1000 passi", {QKeySequence(Qt::ALT | Qt::Key_PageDown), 1000}},
+    };
+    for (const auto &[label, step] : steps) {
+        auto *action = viewMenu->addAction(label);
+        action->setShortcut(step.first);
+        connect(action, &QAction::triggered, this, [this, count = step.second](){ stepSolve(count); });
+    }
 
     // Connette i segnali
     //connect(newGameAction, &QAction::triggered, this, &MainWindow::onNewGame);
+    connect(lockCluesAction, &QAction::toggled, this, &MainWindow::setCluesLocked);
+    connect(checkAction, &QAction::triggered, this, &MainWindow::runCheck);
+    connect(hintAction, &QAction::triggered, this, &MainWindow::requestHint);
+    connect(fillForcedAction, &QAction::triggered, this, &MainWindow::fillForcedCells);
+    connect(undoAction, &QAction::triggered, this, &MainWindow::undoEdit);
+    connect(redoAction, &QAction::triggered, this, &MainWindow::redoEdit);
     connect(exitAction, &QAction::triggered, this, &QWidget::close);
 }
 
 // Ensure background thread is stopped on window close
 void MainWindow::closeEvent(QCloseEvent* event)
 {
-    if (solverThread) {
-        // Request the worker thread event loop to stop and wait for it
-        if (solverThread->isRunning()) {
-            solverThread->quit();
-            solverThread->wait();
+    // A running solve is stopped first: the window closes when it returns, so its state is saved
+    if (solveRunning) {
+        service->cancel(SolverJobKind::Solve);
+        if (service->isBusy(SolverJobKind::Solve)) {
+            closePending = true;
+            event->ignore();
+            return;
         }
-        solverThread->deleteLater();
-        solverThread = nullptr;
+        // era solo in coda: non partirà più
+        solveRunning = false;
     }
+
+    // Every job is asked to stop; the service joins its threads when destroyed
+    service->cancelAll();
+    if (progressTimer) progressTimer->stop();
+    autosaveTimer->stop();
+
+    if (solver)
+        session.save(sessionData());
+
     QMainWindow::closeEvent(event);
 }
 
@@ -122,20 +214,17 @@ void MainWindow::closeEvent(QCloseEvent* event)
 // --- QUESTA È LA FUNZIONE CHIAVE PER L'ALLINEAMENTO ---
 void MainWindow::resizeEvent(QResizeEvent *event)  {
     QMainWindow::resizeEvent(event);
-    if (!gridWidget || !optionPanel) return;
+    if (!gridView || !optionPanel) return;
 
     // 1. Calcoliamo la geometria quadrata basandoci SOLO sulla griglia (Master)
-    QSize gSize = gridWidget->size();
+    QSize gSize = gridView->size();
     int lato = qMin(gSize.width(), gSize.height());
 
     // Calcoliamo i margini necessari per centrare il quadrato
     int margineX = (gSize.width() - lato) / 2;
     int margineY = (gSize.height() - lato) / 2;
 
-    // 2. Applichiamo i margini alla GRIGLIA (per farla quadrata)
-    if (gridWidget->layout()) {
-        gridWidget->layout()->setContentsMargins(margineX, margineY, margineX, margineY);
-    }
+    // 2. La GRIGLIA si centra da sola: la vista disegna un quadrato nel suo spazio
 
     // 3. Applichiamo gli STESSI margini orizzontali al PANNELLO OPZIONI
     // In questo modo, il pannello sotto inizia e finisce esattamente dove finisce la griglia sopra.
@@ -145,180 +234,38 @@ void MainWindow::resizeEvent(QResizeEvent *event)  {
     }
 }
 
-// --- Funzione per tracciare la cella selezionata ---
-bool MainWindow::eventFilter(QObject *watched, QEvent *event) {
-    if (event->type() == QEvent::FocusIn) {
-        if (auto *edit = qobject_cast<QLineEdit*>(watched)) {
-            selectedCell = edit;
-        }
-        return false;
+// === Slots ===
+// --- GESTIONE INPUT DA TASTIERA ---
+void MainWindow::handleCellInput(unsigned short row, unsigned short col, unsigned short val) {
+    if (val != 0 && !acceptsValue(row, col, val)) {
+        QMessageBox::warning(this, tr("Errore"), QString(tr("Il numero %1 non è valido in posizione (%2, %3).")).arg(SudokuGridView::symbolFor(val)).arg(row+1).arg(col+1));
+        return;
     }
 
-    if (event->type() == QEvent::KeyPress) {
-
-        QKeyEvent* keyEvent = static_cast<QKeyEvent*>(event);
-        QLineEdit* edit = qobject_cast<QLineEdit*>(watched);
-
-        if (!edit) return false;
-
-        // Quando la cella riceve il focus (es. click o tab), la ricordiamo
-        if (event->type() == QEvent::FocusIn) {
-            selectedCell = edit;
-            return QMainWindow::eventFilter(watched, event); // lascia comportamento di default
-        }
-
-        // Quando la cella viene cliccata con il mouse, impostiamo selectedCell (ridondante con FocusIn)
-        if (event->type() == QEvent::MouseButtonPress) {
-            selectedCell = edit;
-            return QMainWindow::eventFilter(watched, event);
-        }
-
-        int r = edit->property("row").toInt();
-        int c = edit->property("col").toInt();
-
-        selectedCell = edit;
-
-        switch (keyEvent->key()) {
+    dropShownSolution(row, col);
 
-        case Qt::Key_Left:
-            if (c > 0){
-                selectedCell = cells[r][c-1];
-                cells[r][c-1]->setFocus();
-            }
-            return true;
-
-        case Qt::Key_Right:
-            if (c < dim-1){
-                cells[r][c+1]->setFocus();
-                selectedCell = cells[r][c+1];
-            }
-            return true;
-
-        case Qt::Key_Up:
-            if (r > 0){
-                cells[r-1][c]->setFocus();
-                selectedCell = cells[r-1][c];
-            }
-            return true;
-
-        case Qt::Key_Down:
-            if (r < dim-1){
-                cells[r+1][c]->setFocus();
-                selectedCell = cells[r+1][c];
-            }
-            return true;
-
-        case Qt::Key_Escape: { // è da rivedere
-            selectedCell = nullptr;
-            clearFocus();
-            return true;
-        }
+    if (val == 0)
+        solver->clean(row, col);
+    else
+        solver->insert(val, row, col);
 
-            case Qt::Key_F1: {  // da sviluppare
-                askSolve();
-                return true;
-            }
+    history.record(row * dim + col, model->value(row, col), val);
 
-        default:
-            return false;
-        }
-    }
-
-    return false;
+    // Voce dell'utente: non più risolta né segnata come errata
+    model->setCell(row, col, val, model->flags(row, col) & ~(SudokuGridModel::Solved | SudokuGridModel::Wrong));
+    noteGridEdit(row, col);
 }
 
-// === Slots ===
-// --- GESTIONE INPUT DA TASTIERA ---
-void MainWindow::handleCellInput(unsigned short row, unsigned short col, const QString &text) {
-    unsigned short val = text.isEmpty() ? 0 : text.toUShort();
+// === UI setup helpers ===
+SudokuGridView* MainWindow::setupGrid(const unsigned short &size){
+    // Un solo widget disegna tutta la griglia dal modello
+    model = new SudokuGridModel(size, this);
+    SudokuGridView* view = new SudokuGridView(model, this);
 
-    if (val == 0) {
-        solver->clean(row, col);
-    } else {
-        if (solver->isSafe(row, col, val)){
-            solver->insert(val, row, col);
-            cells[row][col]->setStyleSheet(cells[row][col]->styleSheet() + "color: black;"); // Colore per input utente
-        } else {
-            QMessageBox::warning(this, tr("Errore"), QString(tr("Il numero %1 non è valido in posizione (%2, %3).")).arg(val).arg(row+1).arg(col+1));
-            cells[row][col]->clear();
-        }
-    }
-}
+    connect(view, &SudokuGridView::cellEdited, this, &MainWindow::handleCellInput);
+    connect(view, &SudokuGridView::solveRequested, this, &MainWindow::askSolve);
 
-// === UI setup helpers ===
-QWidget* MainWindow::setupGrid(const unsigned short &size){
-    QWidget* gridPanel = new QWidget(this);
-    QGridLayout* sudokuGrid = new QGridLayout(gridPanel);
-
-    unsigned short sqrt_size = std::sqrt(size);
-
-    sudokuGrid->setSpacing(0);
-    sudokuGrid->setContentsMargins(0, 0, 0, 0);
-
-    for (unsigned short i = 0; i < size; ++i) {
-        sudokuGrid->setRowStretch(i, 1);
-        sudokuGrid->setColumnStretch(i, 1);
-    }
-
-    //QRegularExpression rx("^[1-9]$");
-    QRegularExpression rx ("^[1-9A-Ga-g]$");
-    QValidator *validator = new QRegularExpressionValidator(rx, this);
-
-    for (unsigned short row = 0; row < size; row++){
-        for (unsigned short col = 0; col < size; col++){
-            QLineEdit *cell = new QLineEdit;
-
-            cell->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-            cell->setMinimumSize(30, 30);
-            cell->setAlignment(Qt::AlignCenter);
-            cell->setMaxLength(1);
-            cell->setFont(font);
-            cell->setValidator(validator);
-
-            cell->setProperty("row", row);
-            cell->setProperty("col", col);
-
-            // --- CONNESSIONE PER INPUT DA TASTIERA ---
-            // Quando il testo è modificato (dopo la validazione), chiamiamo la funzione di gestione
-            connect(cell, &QLineEdit::textEdited, this, [this, row, col](const QString &text) {
-                this->handleCellInput(row, col, text);
-            });
-
-            // --- CONNESSIONE PER TRACCIARE LA SELEZIONE ---
-            // Quando la cella ottiene il focus
-            connect(cell, &QLineEdit::editingFinished, this, [](){
-                // Usiamo editingFinished come un modo per reagire dopo che la cella perde il focus,
-                // ma per tracciare la selezione usiamo focusInEvent se fosse disponibile.
-                // Per la semplicità di un QLineEdit, basta tracciare quale ha il focus.
-            });
-
-            connect(cell, &QLineEdit::textChanged, this, [this, row, col](const QString &text){});
-            // Per tracciare la cella selezionata, usiamo un Event Filter (vedi nota sotto)
-            // o sovrascriviamo l'evento, ma qui usiamo l'event filter più semplice.
-            cell->installEventFilter(this);
-
-            QString style = "QLineEdit { "
-                            "background-color: white; "
-                            "border: 1px solid #c0c0c0; "
-                            "color: #333; "
-                            "}"
-                            "QLineEdit:focus {"
-                            "    border: 2px solid #0078d4;"
-                            "    background-color: #e3f2fd;"
-                            "}";
-
-            if (col % sqrt_size == sqrt_size-1) style.append("QLineEdit { border-right: 2px solid black; }");
-            if (row % sqrt_size == sqrt_size-1) style.append("QLineEdit { border-bottom: 2px solid black; }");
-
-            cell->setStyleSheet(style);
-            sudokuGrid->addWidget(cell, row, col);
-
-            cells[row][col] = cell;
-
-            solver->insert(cell->text().toUShort(), row, col);
-        }
-    }
-    return gridPanel;
+    return view;
 }
 
 QWidget* MainWindow::setupOptionsPanel(const unsigned short &size){
@@ -358,14 +305,14 @@ QWidget* MainWindow::setupNumberPad(const unsigned short &size)
     }
 
     for (unsigned short i = 1; i <= size; ++i) {
-        QPushButton *numBtn = new QPushButton(QString::number(i));
+        QPushButton *numBtn = new QPushButton(SudokuGridView::symbolFor(i));
         connect(numBtn, &QPushButton::clicked, this, [this, i]() {
             this->handleNumberPadInput(i);
         });
         numBtn->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
         numBtn->setMinimumSize(30, 30);
         //numBtn->setFont(font);
-        numBtn->setFont(QFont("Arial", 25, QFont::Bold));
+        numBtn->setFont(QFont("Arial", size <= 16 ? 25 : 14, QFont::Bold));
         int temp = std::sqrt(size);
         padLayout->addWidget(numBtn, (i-1)/std::sqrt(size), (i-1)%temp);
     }
@@ -407,30 +354,29 @@ void MainWindow::askResetCells(){
 }
 
 void MainWindow::resetCells(){
-
-    for (unsigned short i = 0; i < dim; i++){
-        for (unsigned short j = 0; j < dim; j++) {
-            QString style = "QLineEdit { "
-                            "background-color: white; "
-                            "border: 1px solid #c0c0c0; "
-                            "color: #333; "
-                            "}"
-                            "QLineEdit:focus {"
-                            "    border: 2px solid #0078d4;"
-                            "    background-color: #e3f2fd;"
-                            "}";
-            if(cells[i][j]) {
-                cells[i][j]->clear();
-                unsigned short sqrt_size = std::sqrt(dim);
-                if (j% sqrt_size == sqrt_size-1) style.append("QLineEdit { border-right: 2px solid black; }");
-                if (i % sqrt_size == sqrt_size-1) style.append("QLineEdit { border-bottom: 2px solid black; }");
-                cells[i][j]->setStyleSheet(style);
-                if (cells[i][j]->isReadOnly())
-                    cells[i][j]->setReadOnly(false);
-            }
-        }
+    solutionShown = false;
+    ++editGeneration;
+
+    // si torna in modalità modifica: tutte le celle sono di nuovo indizi
+    cluesLocked = false;
+    if (lockCluesAction) {
+        QSignalBlocker blocker(lockCluesAction);
+        lockCluesAction->setChecked(false);
     }
+
+    // il ripristino si annulla in un colpo solo
+    history.closeGroup();
+    for (unsigned short r = 0; r < dim; ++r)
+        for (unsigned short c = 0; c < dim; ++c)
+            history.record(r * dim + c, model->value(r, c), 0);
+    history.closeGroup();
+    recording.clear();
+
+    model->clear();
+    gridView->setReadOnly(false);
     solver->clean();
+
+    clueChanged();
 }
 
 void MainWindow::askSolve(){
@@ -444,136 +390,697 @@ void MainWindow::askSolve(){
 
 void MainWindow::solveSequence()
 {
-    QString finalStyle = "QLineEdit { "
-        "background-color: #0ABAB5; "
-        "border: 1px solid #c0c0c0; "
-        "color: #333; "
-        "}"
-        "QLineEdit:focus {"
-        "    border: 2px solid #0078d4;"
-        "    background-color: #e3f2fd;"
-        "}";
+    // una sola risoluzione alla volta, compreso il replay dei passi e la loro revisione
+    if (solveRunning || (progressTimer && progressTimer->isActive()) || !recording.atEnd()) return;
+
     // Prepare progress tracking for a new run
     lastCoordsSize = 0;
+    solveDone = false;
     if (solver) solver->clearProgress();
 
-    for (unsigned short i = 0; i < dim; i++)
-        for (unsigned short j = 0; j < dim; j++)
-            cells[i][j]->setReadOnly(true);
+    // A velocità massima non si registra nessun passo: si mostra solo il risultato
+    const bool animate = progressMode != ProgressMode::MaxSpeed;
+    solver->setProgressRecording(animate);
 
-    QThread* thread = new QThread;
-    SolverWorker* worker = new SolverWorker(solver);
+    gridView->setReadOnly(true);
 
-    worker->moveToThread(thread);
+    // La griglia di partenza: i passi diventano variazioni rispetto a questa
+    // Da qui il solver appartiene al worker: gli indizi si leggono da una copia fino alla fine
+    solveStartValues.resize(dim * dim);
+    solveStartGiven.resize(dim * dim);
+    for (unsigned short r = 0; r < dim; ++r)
+        for (unsigned short c = 0; c < dim; ++c) {
+            solveStartValues[r * dim + c] = static_cast<uint8_t>(model->value(r, c));
+            solveStartGiven[r * dim + c] = solver->isGiven(r, c);
+        }
+    recording.start(dim, solveStartValues);
 
-    // Ensure cleanup regardless of success path
-    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    solveRunning = true;
+    service->submit({SolverJobKind::Solve, 0, solver});
 
-    connect(thread, &QThread::started, worker, &SolverWorker::run);
+    // avvia monitor (usa lastCoordsSize membro, viene azzerato all'inizio)
+    if (animate)
+        startProgressMonitor();
+}
 
-    // quando la solve termina
-    connect(worker, &SolverWorker::finished,
-            this, [=](bool ok){
-                qDebug() << "Solver terminato, risultato:" << ok;
+void MainWindow::onJobFinished(const SolverResult &result)
+{
+    switch (result.kind) {
+    case SolverJobKind::Solve:
+        qDebug() << "Solver terminato, risultato:" << result.solved;
+
+        solveRunning = false;
+        solveDone = true;
+        solveOk = result.solved;
+
+        // fermata per chiudere la finestra: la ricerca si salva così com'è
+        if (closePending) {
+            close();
+            return;
+        }
 
-                // aggiorna griglia completa
-                for (unsigned short r = 0; r < dim; ++r){
-                    for (unsigned short c = 0; c < dim; ++c){
-                        cells[r][c]->setText(QString::number(solver->get(r, c)));
-                        //cells[r][c]->setStyleSheet(finalStyle);
-                    }
-                }
+        // con l'animazione attiva chiude il monitor, dopo l'ultimo frame
+        if (!progressTimer || !progressTimer->isActive())
+            completeSolve();
+        break;
 
-                // sblocca GUI
-                // si sblocca solo dopo reset
+    case SolverJobKind::Hint:
+        hintPending = false;
 
-                // pulizia thread/worker
-                thread->quit();
-                thread->wait();
+        // la griglia è cambiata nel frattempo: il suggerimento non vale più
+        if (result.tag != editGeneration) return;
 
-                worker->deleteLater();
-                thread->deleteLater();
+        showHint(result.hint.row, result.hint.column, result.hint.value, static_cast<int>(result.hint.technique));
+        break;
 
-                // reset stato in MainWindow
-                solverThread = nullptr;
-                lastCoordsSize = 0;
+    case SolverJobKind::Check:
+        // risultato di indizi ormai cambiati: si scarta
+        if (result.tag != clueGeneration) return;
 
-                if (ok)
-                    QMessageBox::information(this, tr("Completato"), tr("Sudoku risolto"));
-                else
-                    QMessageBox::critical(this, tr("Errore"), tr("Il sudoku non è stato risolto"));
-            });
+        checkReadyGeneration = result.tag;
+        checkSolutions = static_cast<int>(result.solutions);
+        checkSolution = result.grid;
 
-    // salva il thread nel membro e avvialo
-    solverThread = thread;
-    thread->start();
+        if (checkPending) {
+            checkPending = false;
+            showCheckResult();
+        }
+        break;
 
-    // avvia monitor (usa lastCoordsSize membro, viene azzerato all'inizio)
-    startProgressMonitor();
+    case SolverJobKind::Count:
+        break;
+    }
 }
 
-void MainWindow::startProgressMonitor()
+void MainWindow::completeSolve()
 {
-    // usa il membro lastCoordsSize (non statico), così si resetta tra esecuzioni
-    QTimer* timer = new QTimer(this);
-
-    /*QString solvedColor = "QLineEdit { "
-                          "background-color: #FFD16E; "
-                          "border: 1px solid #c0c0c0; "
-                          "color: #333; "
-                          "}"
-                          "QLineEdit:focus {"
-                          "    border: 2px solid #0078d4;"
-                          "    background-color: #e3f2fd;"
-                          "}";*/
-
-    connect(timer, &QTimer::timeout, this, [this, timer/*, solvedColor*/]() {
-        size_t size = solver->coordsSize();
-
-
-        if (size > lastCoordsSize) {
-            for (unsigned short k = lastCoordsSize; k < size; ++k) {
-                auto [r, c] = solver->coordAt(k);
-                unsigned short v = solver->get(r, c);
-                cells[r][c]->setText(QString::number(v));
-                //cells[r][c]->setStyleSheet(solvedColor);
-                qDebug() << "Aggiornata cella:" << r << c << " = " << v;
-            }
-            lastCoordsSize = size;
+    // aggiorna griglia completa, con un solo ridisegno; la risoluzione è un gruppo della cronologia
+    std::vector<unsigned short> values(dim * dim);
+    solver->store(values);
+
+    history.closeGroup();
+    bool changed = false;
+    model->beginUpdate();
+    for (unsigned short r = 0; r < dim; ++r){
+        for (unsigned short c = 0; c < dim; ++c){
+            const unsigned short v = values[r * dim + c];
+            history.record(r * dim + c, solveStartValues[r * dim + c], v);
+            changed = changed || v != solveStartValues[r * dim + c];
+            quint8 flags = model->flags(r, c) & ~SudokuGridModel::Solved;
+            if (v && !solver->isGiven(r, c)) flags |= SudokuGridModel::Solved;
+            model->setCell(r, c, v, flags);
         }
+    }
+    model->endUpdate();
+
+    // rifare questo gruppo deve mostrare di nuovo la soluzione, non trasformarla in indizi
+    if (changed && solveOk)
+        history.markSolve(solver->snapshot());
+
+    // sblocca GUI: gli indizi restano modificabili, il solver
+    // tiene la soluzione in cache per la prossima risoluzione
+    gridView->setReadOnly(false);
+    solutionShown = solveOk;
+    ++editGeneration;
+    recordingGeneration = editGeneration;
+    history.closeGroup();
+    lastCoordsSize = 0;
 
-        // Se il thread è nullo o non è in esecuzione, fermiamo il timer
-        if (!solverThread || !solverThread->isRunning()) {
-            timer->stop();
-            timer->deleteLater();
-        }
-    });
+    if (solveOk)
+        QMessageBox::information(this, tr("Completato"), tr("Sudoku risolto"));
+    else
+        QMessageBox::critical(this, tr("Errore"), tr("Il sudoku non è stato risolto"));
+
+    // controllo chiesto durante la risoluzione, con il risultato già pronto
+    if (checkPending && checkSolutions >= 0 && checkReadyGeneration == clueGeneration) {
+        checkPending = false;
+        showCheckResult();
+    }
+}
+
+void MainWindow::startProgressMonitor()
+{
+    // un solo timer, riusato tra le esecuzioni
+    if (!progressTimer) {
+        progressTimer = new QTimer(this);
+        progressTimer->setTimerType(Qt::PreciseTimer);
+        connect(progressTimer, &QTimer::timeout, this, &MainWindow::renderProgressFrame);
+    }
+
+    replayCredit = 0;
+    frameClock.start();
+    progressTimer->start(frameInterval());
+}
+
+void MainWindow::renderProgressFrame()
+{
+    const size_t available = solver->coordsSize();
+    const qint64 elapsed = frameClock.restart();
+
+    // In replay si avanza di un numero fisso di passi al secondo, altrimenti fino all'ultimo
+    size_t target = available;
+    if (progressMode == ProgressMode::Replay) {
+        replayCredit += replaySpeed * elapsed / 1000.0;
+        const size_t budget = static_cast<size_t>(replayCredit);
+        target = qMin(available, lastCoordsSize + budget);
+        replayCredit = target == available ? 0 : replayCredit - static_cast<double>(target - lastCoordsSize);
+    }
+
+    if (target > lastCoordsSize) {
+        progressBuffer.clear();
+        solver->progressRange(lastCoordsSize, target, progressBuffer);
+        recording.append(progressBuffer);
+        applyProgress(progressBuffer);
+        lastCoordsSize = target;
+
+        // il solver produce passi: si torna al ritmo dello schermo
+        progressTimer->setInterval(frameInterval());
+    } else if (progressMode != ProgressMode::Replay) {
+        // solver lento (o fermo): meno frame a vuoto, fino a 100 ms
+        progressTimer->setInterval(qMin(progressTimer->interval() * 2, 100));
+    }
 
-    timer->start(100); // ogni 100 ms (regola come preferisci)
+    // Il replay finisce quando ha mostrato tutti i passi registrati
+    const bool caughtUp = progressMode != ProgressMode::Replay || lastCoordsSize >= solver->coordsSize();
+    if (solveDone && caughtUp) {
+        progressTimer->stop();
+        completeSolve();
+    }
+}
+
+void MainWindow::applyProgress(const std::vector<SudokuSolverAlgorithm::ProgressStep> &steps)
+{
+    // Si tiene solo l'ultimo valore di ogni cella toccata nel frame
+    if (frameValues.size() != dim * dim)
+        frameValues.fill(-1, dim * dim);
+
+    for (const auto &step : steps) {
+        const int index = step.row * dim + step.column;
+        if (frameValues[index] < 0)
+            frameTouched.append(index);
+        frameValues[index] = step.value;
+    }
+
+    model->beginUpdate();
+    for (int index : frameTouched) {
+        const unsigned short v = static_cast<unsigned short>(frameValues[index]);
+        model->setCell(index / dim, index % dim, v, v ? SudokuGridModel::Solved : SudokuGridModel::NoFlag);
+        frameValues[index] = -1;
+    }
+    model->endUpdate();
+
+    frameTouched.clear();
+}
+
+int MainWindow::frameInterval() const
+{
+    // Un tick per refresh dello schermo (60 Hz se non noto)
+    const QScreen* s = screen();
+    const qreal hz = s && s->refreshRate() > 0 ? s->refreshRate() : 60.0;
+    return qMax(1, qRound(1000.0 / hz));
 }
 
 void MainWindow::handleNumberPadInput(unsigned short val)
 {
-    if (!selectedCell) return;
+    if (!gridView->hasSelection() || gridView->isReadOnly()) return;
+
+    unsigned short row = gridView->selectedRow();
+    unsigned short col = gridView->selectedColumn();
 
-    unsigned short row = selectedCell->property("row").toInt();
-    unsigned short col = selectedCell->property("col").toInt();
+    // gli indizi bloccati non si modificano
+    if (model->hasFlag(row, col, SudokuGridModel::Given)) return;
 
-    if (!solver->isSafe(row, col, val)) {
+    if (!acceptsValue(row, col, val)) {
         QMessageBox::warning(this, tr("Errore"),
                              tr("Il numero %1 non è valido in posizione (%2, %3).")
-                                 .arg(val).arg(row+1).arg(col+1));
+                                 .arg(SudokuGridView::symbolFor(val)).arg(row+1).arg(col+1));
         return;
     }
 
-    selectedCell->setText(QString::number(val));
+    dropShownSolution(row, col);
+
     solver->insert(val, row, col);
+    history.record(row * dim + col, model->value(row, col), val);
+    model->setCell(row, col, val, model->flags(row, col) & ~(SudokuGridModel::Solved | SudokuGridModel::Wrong));
+    noteGridEdit(row, col);
 
     // opzionale: focus avanti
     int nc = col + 1;
     int nr = row;
     if (nc >= dim) { nc = 0; nr++; }
-    if (nr < dim) cells[nr][nc]->setFocus();
+    if (nr < dim) gridView->setSelectedCell(nr, nc);
+}
+
+void MainWindow::dropShownSolution(int keepRow, int keepCol)
+{
+    if (!solutionShown) return;
+    solutionShown = false;
+
+    solver->resetToClues();
+
+    // Si toglie la soluzione nello stesso gruppo della modifica che segue
+    history.closeGroup();
+    model->beginUpdate();
+    for (unsigned short r = 0; r < dim; ++r)
+        for (unsigned short c = 0; c < dim; ++c)
+            if (!solver->isGiven(r, c) && !(r == keepRow && c == keepCol)) {
+                history.record(r * dim + c, model->value(r, c), 0);
+                model->setCell(r, c, 0, model->flags(r, c) & ~(SudokuGridModel::Solved | SudokuGridModel::Wrong));
+            }
+    model->endUpdate();
+}
+
+bool MainWindow::acceptsValue(unsigned short row, unsigned short col, unsigned short val) const
+{
+    if (!solutionShown) return solver->isSafe(row, col, val);
+
+    // Soluzione mostrata: si confronta con i soli indizi, gli altri valori spariranno
+    const unsigned short block = static_cast<unsigned short>(qRound(std::sqrt(dim)));
+    for (unsigned short r = 0; r < dim; ++r)
+        for (unsigned short c = 0; c < dim; ++c) {
+            const bool peer = r == row || c == col || (r / block == row / block && c / block == col / block);
+            if (peer && !(r == row && c == col) && solver->isGiven(r, c) && solver->get(r, c) == val)
+                return false;
+        }
+    return true;
+}
+
+void MainWindow::undoEdit()
+{
+    if (solveRunning || gridView->isReadOnly()) return;
+    applyHistory(history.undo(), true);
+}
+
+void MainWindow::redoEdit()
+{
+    if (solveRunning || gridView->isReadOnly()) return;
+    applyHistory(history.redo(), false);
+}
+
+void MainWindow::applyHistory(const HistoryGroup &group, bool undo)
+{
+    if (group.deltas.empty()) return;
+
+    // Rifare una risoluzione rimette lo stato del solver che la mostrava: gli indizi non cambiano
+    const bool showSolution = !undo && group.solved;
+    solutionShown = showSolution;
+
+    if (showSolution) {
+        solver->restore(*group.solved);
+    } else {
+        // Prima si svuotano le celle che cambiano, poi si scrivono i valori:
+        // così un valore non viene inserito mentre è ancora usato altrove
+        for (const GridDelta &d : group.deltas)
+            solver->clean(d.cell / dim, d.cell % dim);
+    }
+
+    model->beginUpdate();
+    for (const GridDelta &d : group.deltas) {
+        const unsigned short r = d.cell / dim;
+        const unsigned short c = d.cell % dim;
+        const unsigned short v = undo ? d.before : d.after;
+        quint8 flags = model->flags(r, c) & ~(SudokuGridModel::Solved | SudokuGridModel::Wrong);
+        if (showSolution) {
+            if (v && !solver->isGiven(r, c)) flags |= SudokuGridModel::Solved;
+        } else if (v) {
+            solver->insert(v, r, c);
+        }
+        model->setCell(r, c, v, flags);
+    }
+    model->endUpdate();
+
+    ++editGeneration;
+    if (!showSolution && !cluesLocked) clueChanged();
 }
 
+void MainWindow::stepSolve(long long steps)
+{
+    // solo finché la griglia mostra la risoluzione registrata
+    if (solveRunning || recording.size() == 0 || editGeneration != recordingGeneration) return;
+
+    const size_t position = recording.position();
+    const size_t target = steps < 0 ? position - qMin<size_t>(position, static_cast<size_t>(-steps))
+                                    : position + static_cast<size_t>(steps);
+    if (!recording.seek(target, progressBuffer)) return;
+
+    applyProgress(progressBuffer);
+    gridView->setReadOnly(!recording.atEnd());
+
+    const size_t dropped = recording.droppedSteps();
+    statusBar()->showMessage(tr("Passo %1 di %2").arg(recording.position() + dropped).arg(recording.size() + dropped), 5000);
+}
+
+void MainWindow::requestHint()
+{
+    // Durante la risoluzione la griglia è bloccata
+    if (solveRunning || hintPending) return;
+
+    if (solutionShown) {
+        statusBar()->showMessage(tr("Il sudoku è già risolto"), 5000);
+        return;
+    }
+
+    // il suggerimento si cerca su una copia, la griglia resta modificabile
+    auto copy = std::make_shared<SudokuSolverAlgorithm>(dim);
+    std::vector<unsigned short> values(dim * dim);
+    solver->store(values);
+    copy->load(values);
+
+    // Budget di mezzo frame: il suggerimento deve arrivare entro un paio di frame
+    SolverJob job{SolverJobKind::Hint, editGeneration, copy};
+    job.budget = std::chrono::milliseconds(8);
+
+    hintPending = true;
+    service->submit(job);
+}
+
+void MainWindow::showHint(int row, int col, int value, int technique)
+{
+    using Technique = SudokuSolverAlgorithm::HintTechnique;
+
+    QString reason;
+    switch (static_cast<Technique>(technique)) {
+    case Technique::None:
+        statusBar()->showMessage(tr("Nessuna mossa logica semplice trovata"), 5000);
+        return;
+    case Technique::Contradiction:
+        gridView->setSelectedCell(row, col);
+        statusBar()->showMessage(tr("La cella (%1, %2) non ha valori possibili").arg(row+1).arg(col+1), 5000);
+        return;
+    case Technique::NakedSingle:
+        reason = tr("unico candidato della cella");
+        break;
+    case Technique::HiddenSingle:
+        reason = tr("unica posizione nella riga, colonna o blocco");
+        break;
+    case Technique::LockedCandidates:
+        reason = tr("candidati bloccati");
+        break;
+    }
+
+    solver->insert(value, row, col);
+
+    // un suggerimento si annulla da solo, non insieme ai tasti premuti prima
+    history.closeGroup();
+    history.record(row * dim + col, model->value(row, col), value);
+    history.closeGroup();
+
+    model->setValue(row, col, value);
+    noteGridEdit(row, col);
+
+    gridView->setSelectedCell(row, col);
+
+    statusBar()->showMessage(tr("Suggerimento: %1 in posizione (%2, %3), %4")
+                                 .arg(SudokuGridView::symbolFor(value)).arg(row+1).arg(col+1).arg(reason), 5000);
+}
+
+void MainWindow::fillForcedCells()
+{
+    // Durante la risoluzione la griglia è bloccata
+    if (solveRunning) return;
+
+    if (solutionShown) {
+        statusBar()->showMessage(tr("Il sudoku è già risolto"), 5000);
+        return;
+    }
+
+    // Solo deduzioni, nessun tentativo: bastano pochi microsecondi, niente thread
+    const std::vector<SudokuSolverAlgorithm::Hint> forced = solver->forcedPlacements();
+    if (!forced.empty() && forced.back().technique == SudokuSolverAlgorithm::HintTechnique::Contradiction) {
+        const SudokuSolverAlgorithm::Hint &wrong = forced.back();
+        gridView->setSelectedCell(wrong.row, wrong.column);
+        if (wrong.value == 0)
+            statusBar()->showMessage(tr("La cella (%1, %2) non ha valori possibili").arg(wrong.row+1).arg(wrong.column+1), 5000);
+        else
+            statusBar()->showMessage(tr("Il numero %1 non ha posto vicino alla cella (%2, %3)")
+                                         .arg(SudokuGridView::symbolFor(wrong.value)).arg(wrong.row+1).arg(wrong.column+1), 5000);
+        return;
+    }
+    if (forced.empty()) {
+        statusBar()->showMessage(tr("Nessuna cella forzata"), 5000);
+        return;
+    }
+
+    // Tutte le celle in un solo aggiornamento della griglia e in un solo passo di annullamento
+    history.closeGroup();
+    model->beginUpdate();
+    for (const SudokuSolverAlgorithm::Hint &placement : forced) {
+        solver->insert(placement.value, placement.row, placement.column);
+        history.record(placement.row * dim + placement.column, model->value(placement.row, placement.column), placement.value);
+        model->setValue(placement.row, placement.column, placement.value);
+        model->setFlag(placement.row, placement.column, SudokuGridModel::Wrong, false);
+    }
+    model->endUpdate();
+    history.closeGroup();
+
+    // Una sola modifica per tutto il lotto: un solo riavvio del controllo degli indizi
+    ++editGeneration;
+    if (!cluesLocked)
+        clueChanged();
+
+    statusBar()->showMessage(tr("%n celle forzate riempite", nullptr, static_cast<int>(forced.size())), 5000);
+}
+
+bool MainWindow::isClueCell(unsigned short row, unsigned short col) const
+{
+    if (cluesLocked)
+        return model->hasFlag(row, col, SudokuGridModel::Given);
+    return isSolverClue(row, col);
+}
+
+bool MainWindow::isSolverClue(unsigned short row, unsigned short col) const
+{
+    // durante la risoluzione il worker scrive la griglia del solver
+    if (solveRunning)
+        return solveStartGiven[row * dim + col];
+    return solver->isGiven(row, col);
+}
+
+void MainWindow::noteGridEdit(unsigned short row, unsigned short col)
+{
+    ++editGeneration;
+
+    if (!cluesLocked) {
+        clueChanged();
+        return;
+    }
+
+    // indizi bloccati: cambia solo una voce dell'utente, il controllo resta valido
+    model->setFlag(row, col, SudokuGridModel::Wrong, false);
+}
+
+void MainWindow::clueChanged()
+{
+    ++clueGeneration;
+
+    // il calcolo in corso riguarda indizi vecchi: lo si ferma e si aspetta che si stabilizzino
+    service->cancel(SolverJobKind::Check);
+
+    clueTimer->start();
+}
+
+void MainWindow::setCluesLocked(bool locked)
+{
+    cluesLocked = locked;
+
+    model->beginUpdate();
+    for (unsigned short r = 0; r < dim; ++r)
+        for (unsigned short c = 0; c < dim; ++c)
+            model->setFlag(r, c, SudokuGridModel::Given, locked && isSolverClue(r, c));
+    model->endUpdate();
+
+    if (!locked) {
+        // le voci dell'utente tornano a essere indizi
+        clueChanged();
+        return;
+    }
+
+    // bloccare non cambia gli indizi: se manca il risultato lo si calcola subito
+    clueTimer->stop();
+    startSpeculativeSolve();
+}
+
+void MainWindow::startSpeculativeSolve()
+{
+    if (checkRunningGeneration == clueGeneration && service->isBusy(SolverJobKind::Check)) return;
+    if (checkSolutions >= 0 && checkReadyGeneration == clueGeneration) return;
+
+    auto speculative = std::make_shared<SudokuSolverAlgorithm>(dim);
+    std::vector<unsigned short> clues(dim * dim);
+    if (solveRunning)
+        std::copy(solveStartValues.cbegin(), solveStartValues.cend(), clues.begin());
+    else
+        solver->store(clues);
+    for (unsigned short r = 0; r < dim; ++r)
+        for (unsigned short c = 0; c < dim; ++c)
+            if (!isClueCell(r, c))
+                clues[r * dim + c] = 0;
+    speculative->load(clues);
+
+    checkRunningGeneration = clueGeneration;
+    service->submit({SolverJobKind::Check, clueGeneration, speculative});
+}
+
+void MainWindow::runCheck()
+{
+    if (checkSolutions >= 0 && checkReadyGeneration == clueGeneration) {
+        showCheckResult();
+        return;
+    }
+
+    // risultato non ancora pronto: il controllo parte appena arriva
+    checkPending = true;
+    statusBar()->showMessage(tr("Verifica in corso..."));
+    clueTimer->stop();
+    startSpeculativeSolve();
+}
+
+void MainWindow::showCheckResult()
+{
+    // La griglia cambia a ogni passo della risoluzione: gli errori si segnano alla fine
+    if (solveRunning || (progressTimer && progressTimer->isActive())) {
+        checkPending = true;
+        statusBar()->showMessage(tr("Verifica in corso..."));
+        return;
+    }
+
+    if (checkSolutions == 0) {
+        statusBar()->showMessage(tr("Gli indizi non hanno soluzione"), 5000);
+        return;
+    }
+    if (checkSolutions > 1) {
+        statusBar()->showMessage(tr("Gli indizi ammettono più soluzioni: impossibile controllare"), 5000);
+        return;
+    }
+
+    std::vector<unsigned short> values(dim * dim);
+    solver->store(values);
+
+    int wrong = 0;
+    model->beginUpdate();
+    for (unsigned short r = 0; r < dim; ++r)
+        for (unsigned short c = 0; c < dim; ++c) {
+            const unsigned short v = values[r * dim + c];
+            const bool isWrong = !isClueCell(r, c) && v && v != checkSolution[r * dim + c];
+            model->setFlag(r, c, SudokuGridModel::Wrong, isWrong);
+            if (isWrong) ++wrong;
+        }
+    model->endUpdate();
+
+    if (wrong)
+        statusBar()->showMessage(tr("Valori errati: %1").arg(wrong), 5000);
+    else
+        statusBar()->showMessage(tr("Nessun errore"), 5000);
+}
+
+int MainWindow::sessionMode(const QByteArray &data)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_5);
+
+    quint32 magic = 0;
+    quint8 version = 0;
+    quint16 dimension = 0;
+    in >> magic >> version >> dimension;
+    if (in.status() != QDataStream::Ok || magic != sessionMagic || version != sessionVersion)
+        return -1;
+
+    // Dimensioni della finestra di avvio: blocchi da 3 a 6
+    const int block = qRound(std::sqrt(dimension));
+    if (block < 3 || block > 6 || block * block != dimension)
+        return -1;
+    return block - 2;
+}
+
+QByteArray MainWindow::sessionData() const
+{
+    bool empty = !solver->canResume();
+    for (unsigned short r = 0; r < dim && empty; ++r)
+        for (unsigned short c = 0; c < dim && empty; ++c)
+            empty = solver->get(r, c) == 0;
+    if (empty)
+        return {};
+
+    // Indizi bloccati: sono gli unici che il solver non distingue dalle voci dell'utente
+    QBitArray locked(dim * dim);
+    if (cluesLocked)
+        for (unsigned short r = 0; r < dim; ++r)
+            for (unsigned short c = 0; c < dim; ++c)
+                locked.setBit(r * dim + c, model->hasFlag(r, c, SudokuGridModel::Given));
+
+    std::vector<uint8_t> state;
+    solver->serialize(state);
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_5);
+    out << sessionMagic << sessionVersion << quint16(dim) << cluesLocked << locked
+        << QByteArray(reinterpret_cast<const char*>(state.data()), static_cast<qsizetype>(state.size()));
+    return data;
+}
+
+bool MainWindow::restoreSession(const QByteArray &data)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_5);
+
+    quint32 magic = 0;
+    quint8 version = 0;
+    quint16 dimension = 0;
+    bool locked = false;
+    QBitArray lockedCells;
+    QByteArray state;
+    in >> magic >> version >> dimension >> locked >> lockedCells >> state;
+    if (in.status() != QDataStream::Ok || magic != sessionMagic || version != sessionVersion
+        || dimension != dim || lockedCells.size() != dim * dim)
+        return false;
+
+    const std::span<const uint8_t> bytes(reinterpret_cast<const uint8_t*>(state.constData()), static_cast<size_t>(state.size()));
+    if (!solver->deserialize(bytes) || solver->size() != dim) {
+        solver = std::make_shared<SudokuSolverAlgorithm>(dim);
+        return false;
+    }
+
+    // Valori fuori dagli indizi del solver: la soluzione mostrata alla chiusura
+    bool solved = false;
+    model->beginUpdate();
+    for (unsigned short r = 0; r < dim; ++r)
+        for (unsigned short c = 0; c < dim; ++c) {
+            const unsigned short v = solver->get(r, c);
+            quint8 flags = SudokuGridModel::NoFlag;
+            if (locked && lockedCells.testBit(r * dim + c)) flags |= SudokuGridModel::Given;
+            if (v && !solver->isGiven(r, c)) {
+                flags |= SudokuGridModel::Solved;
+                solved = true;
+            }
+            model->setCell(r, c, v, flags);
+        }
+    model->endUpdate();
+
+    cluesLocked = locked;
+    if (lockCluesAction) {
+        QSignalBlocker blocker(lockCluesAction);
+        lockCluesAction->setChecked(locked);
+    }
+    solutionShown = solved;
+
+    ++editGeneration;
+    savedGeneration = editGeneration;
+    savedLocked = cluesLocked;
+    clueChanged();
+
+    if (solver->canResume())
+        statusBar()->showMessage(tr("Risoluzione interrotta: premi Risolvi per riprendere"));
+    return true;
+}
+
+void MainWindow::autosave()
+{
+    if (!solver || solveRunning) return;
+    if (savedGeneration == editGeneration && savedLocked == cluesLocked) return;
+
+    // Si serializza qui (pochi KB), la scrittura avviene nel thread del salvataggio
+    session.saveAsync(sessionData());
+    savedGeneration = editGeneration;
+    savedLocked = cluesLocked;
+}
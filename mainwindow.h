@@ -4,8 +4,18 @@
 #include <QMainWindow>
 #include <QHBoxLayout>
 #include <QVector>
-#include <QLineEdit>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <memory>
+#include <vector>
 #include "libs/SudokuSolverAlgorithm.h"
+#include "SudokuGridModel.h"
+#include "SudokuGridView.h"
+#include "GridHistory.h"
+#include "SessionStore.h"
+#include "solverworker.h"
+
+class SolverService;
 
 
 QT_BEGIN_NAMESPACE
@@ -41,6 +51,22 @@ public:
      */
     ~MainWindow() override;
 
+    /**
+     * @brief Mode (see `initializeForMode`) of a saved session.
+     * @param data Contents of the session file.
+     * @return The mode, or -1 if the data is not a session.
+     */
+    static int sessionMode(const QByteArray &data);
+    /**
+     * @brief Puts back a saved session: puzzle, entries, locked clues and cached solution.
+     *
+     * Call after `initializeForMode(sessionMode(data))`. A solve interrupted when
+     * the window was closed continues from where it stopped at the next "Risolvi".
+     * @param data Contents of the session file.
+     * @return false if the data is not a valid session for this grid.
+     */
+    bool restoreSession(const QByteArray &data);
+
 protected:
     /**
      * @brief Keeps the grid perfectly square and aligns the options panel with it.
@@ -52,32 +78,35 @@ protected:
      */
     void resizeEvent(QResizeEvent *event) override;
     /**
-     * @brief Ensures background solver thread is terminated before the window closes.
+     * @brief Asks every background job to stop and saves the session before the window closes.
+     *
+     * A running solve is stopped first and the window closes once it has
+     * returned, so its search state is saved too.
      */
     void closeEvent(QCloseEvent* event) override;
 
 private slots:
     // Slots
     /**
-     * @brief Handles text edits in a grid cell.
+     * @brief Handles a value typed in a grid cell.
      *
-     * Validates and applies the value to the solver. If invalid, resets the
-     * cell and informs the user.
+     * Validates and applies the value to the solver and the grid model. If
+     * invalid, the cell keeps its previous value and the user is informed.
      * @param row Zero-based row index of the edited cell.
      * @param col Zero-based column index of the edited cell.
-     * @param text The text entered by the user (validated to a single digit 1–9 or empty).
+     * @param val The value typed by the user, or 0 to clear the cell.
      */
-    void handleCellInput(unsigned short row, unsigned short col, const QString &text);
+    void handleCellInput(unsigned short row, unsigned short col, unsigned short val);
 
 private:
     void setupMenu();
     // UI setup helpers
     /**
-     * @brief Creates the Sudoku grid widget and populates it with editable cells.
+     * @brief Creates the grid model and the custom-painted view showing it.
      * @param size Grid dimension (typically 9 for a 9x9 Sudoku).
-     * @return Newly created widget containing the grid layout.
+     * @return Newly created grid view.
      */
-    QWidget* setupGrid(const unsigned short&);
+    SudokuGridView* setupGrid(const unsigned short&);
     /**
      * @brief Creates the lower options panel containing the number pad and action buttons.
      * @param size Grid dimension, used to build the number pad.
@@ -107,13 +136,6 @@ private:
     //void resizeGrid(T&);
 
     // Event handlers and actions
-    /**
-     * @brief Filters key/mouse events on grid cells to support navigation and selection tracking.
-     * @param watched The object being watched.
-     * @param event The event being filtered.
-     * @return true if the event is handled; otherwise false to continue default processing.
-     */
-    bool eventFilter(QObject *watched, QEvent *event) override;
     /**
      * @brief Prompts the user to confirm resetting the entire grid.
      */
@@ -127,16 +149,165 @@ private:
      */
     void askSolve();
     /**
-     * @brief Launches the solver on a worker thread and locks the grid while solving.
+     * @brief Queues a solve on the solver service and locks the grid while solving.
      *
      * On completion, updates the grid with the solved values, unlocks the UI, and
      * informs the user about the outcome.
      */
     void solveSequence();
+    /**
+     * @brief Routes a result of the solver service to the solve, hint or check flow.
+     */
+    void onJobFinished(const SolverResult &result);
     /**
      * @brief Periodically reflects solver progress into the UI while the worker thread runs.
+     *
+     * Ticks once per display refresh while the solver produces steps and backs
+     * off to 100 ms while it does not. Not started in max-speed mode.
      */
     void startProgressMonitor();
+    /**
+     * @brief One monitor tick: reads the new steps with one lock and paints them.
+     *
+     * In replay mode only `replaySpeed` steps per second are consumed, and the
+     * solve is completed once all recorded steps have been shown.
+     */
+    void renderProgressFrame();
+    /**
+     * @brief Collapses a frame of steps to one final value per cell and applies them as one batch.
+     * @param steps Steps in solver order.
+     */
+    void applyProgress(const std::vector<SudokuSolverAlgorithm::ProgressStep> &steps);
+    /**
+     * @brief Shows the final grid, unlocks it and reports the outcome of the solve.
+     */
+    void completeSolve();
+    /**
+     * @brief Milliseconds between two display refreshes of the window's screen.
+     */
+    int frameInterval() const;
+    /**
+     * @brief Looks for the next forced placement on a worker thread.
+     *
+     * A snapshot of the grid is queued on the solver service, so the UI thread never
+     * runs the search; the result is discarded if the grid changed meanwhile.
+     */
+    void requestHint();
+    /**
+     * @brief Applies a hint returned by the worker and explains it in the status bar.
+     * @param row Zero-based row of the hinted cell.
+     * @param col Zero-based column of the hinted cell.
+     * @param value Value to place (0 if there is none).
+     * @param technique A SudokuSolverAlgorithm::HintTechnique value.
+     */
+    void showHint(int row, int col, int value, int technique);
+    /**
+     * @brief Fills every cell forced by logic alone, as one edit.
+     *
+     * The deductions run on the UI thread (no guessing, so they take
+     * microseconds) and the cells are applied in one batched model update,
+     * undone as a single group. A contradiction is reported instead.
+     */
+    void fillForcedCells();
+    /**
+     * @brief Tells whether a cell belongs to the puzzle clues.
+     *
+     * With clues locked these are the cells flagged Given; otherwise every
+     * value inserted in the solver is a clue.
+     */
+    bool isClueCell(unsigned short row, unsigned short col) const;
+    /**
+     * @brief Tells whether a cell is a clue in the solver.
+     *
+     * While a solve runs the solver belongs to the worker thread, so the
+     * answer comes from the copy taken when the solve started.
+     */
+    bool isSolverClue(unsigned short row, unsigned short col) const;
+    /**
+     * @brief Bookkeeping after any edit of a cell (keyboard, number pad or hint).
+     *
+     * With clues unlocked the edit changes the clues; otherwise it only clears
+     * the error mark of the edited entry.
+     */
+    void noteGridEdit(unsigned short row, unsigned short col);
+    /**
+     * @brief Invalidates the speculative solution and restarts the stability timer.
+     */
+    void clueChanged();
+    /**
+     * @brief Locks (or unlocks) the current clues, so later values are user entries.
+     * @param locked true to lock the filled cells as clues.
+     */
+    void setCluesLocked(bool locked);
+    /**
+     * @brief Solves the current clues in the background, counting up to two solutions.
+     *
+     * Started once the clues have been stable for a short while; the result is kept
+     * until the clues change, so a check never waits for a solve.
+     */
+    void startSpeculativeSolve();
+    /**
+     * @brief Compares the entries with the cached solution, or defers until it is ready.
+     */
+    void runCheck();
+    /**
+     * @brief Highlights the entries that differ from the unique solution.
+     */
+    void showCheckResult();
+    /**
+     * @brief Returns the grid to the clues only after a solution has been shown.
+     *
+     * Called before the first edit that follows a solve: the solved values are
+     * cleared from the solver and from the grid (except the cell being edited),
+     * while the solver keeps the solution cached for a warm re-solve.
+     * @param keepRow Row of the cell being edited, or -1.
+     * @param keepCol Column of the cell being edited, or -1.
+     */
+    void dropShownSolution(int keepRow = -1, int keepCol = -1);
+    /**
+     * @brief Tells whether `val` can go at (row, col) without a conflict.
+     *
+     * While a solution is shown only the clues count, as they will once
+     * `dropShownSolution()` has run: a rejected value leaves the grid as it is.
+     */
+    bool acceptsValue(unsigned short row, unsigned short col, unsigned short val) const;
+    /**
+     * @brief Undoes the last group of grid edits (a burst of keystrokes, a hint, a solve...).
+     */
+    void undoEdit();
+    /**
+     * @brief Redoes the last undone group of grid edits.
+     */
+    void redoEdit();
+    /**
+     * @brief Applies one group of the edit history to the solver and the grid.
+     *
+     * Cells are emptied first and filled afterwards, so the solver masks stay
+     * consistent whatever the order of the deltas. Redoing a solve group puts
+     * back the solver state that showed the solution, with its solved marks.
+     * @param group Deltas of the group.
+     * @param undo true to put back the old values, false to apply the new ones.
+     */
+    void applyHistory(const HistoryGroup &group, bool undo);
+    /**
+     * @brief Moves through the steps of the last recorded solve.
+     *
+     * Only while the grid still shows that solve; the grid stays read-only
+     * until the end of the recording is reached again.
+     * @param steps Steps to move, negative to go back.
+     */
+    void stepSolve(long long steps);
+    /**
+     * @brief The session as bytes: grid, locked clues and the solver state.
+     * @return A null array for an empty grid, so no session is kept for it.
+     */
+    QByteArray sessionData() const;
+    /**
+     * @brief Autosave tick: saves in the background, only if something changed.
+     *
+     * Skipped while a solve runs, since the solver belongs to the worker.
+     */
+    void autosave();
     /**
      * @brief Inserts a digit into the currently selected cell via number pad.
      * @param val Digit value in the range [1, dim].
@@ -150,32 +321,109 @@ private:
     QWidget* centralWidget;
     /** Top-level vertical layout stacking grid and options panel. */
     QVBoxLayout* mainLayout;
-    /** Container for the Sudoku grid. */
-    QWidget* gridWidget;
+    /** Custom-painted Sudoku grid. */
+    SudokuGridView* gridView = nullptr;
     /** Container for the lower options. */
-    QWidget* optionPanel;
+    QWidget* optionPanel = nullptr;
     /** Container for the number pad. */
     QWidget* numberPad;
     /** Layout for the number pad (owned by numberPad). */
     QGridLayout* numberPadLayout;
-    /** Currently focused/selected cell (nullptr if none). */
-    QLineEdit* selectedCell = nullptr;
 
     // Member variables — grid/state
-    /** 2D array of pointers to the grid cells. */
-    QVector<QVector<QLineEdit*>> cells;
+    /** Values and display flags of the grid cells, painted by gridView. */
+    SudokuGridModel* model = nullptr;
     /** Grid dimension (e.g., 9 for 9x9). */
-    unsigned short dim;
-    /** Base font used by grid cells. */
-    QFont font;
+    unsigned short dim = 0;
 
     // Member variables — solver/threading
-    /** Pointer to the solver algorithm (owned). */
-    SudokuSolverAlgorithm* solver;
-    /** Pointer to the solver worker thread (nullptr when idle). */
-    QThread* solverThread = nullptr;          // puntatore al thread del solver
+    /** Solver of the grid; shared with the service while a solve runs. */
+    std::shared_ptr<SudokuSolverAlgorithm> solver;
+    /** Persistent threads running solve, hint and check jobs (owned). */
+    SolverService* service = nullptr;
+    /** True while a solve job is queued or running. */
+    bool solveRunning = false;
     /** Last applied progress size used to incrementally mirror solver updates. */
     unsigned long lastCoordsSize = 0;         // ultima dimensione letta di coords
+    /** True once the worker returned; the monitor may still be showing steps. */
+    bool solveDone = false;
+    /** Result of the last solve. */
+    bool solveOk = false;
+
+    // Member variables — progress rendering
+    /** How solver progress is shown. */
+    enum class ProgressMode {
+        /** Every frame shows the latest state reached by the solver. */
+        Realtime,
+        /** No animation: only the final grid is shown. */
+        MaxSpeed,
+        /** Steps are played back at `replaySpeed` steps per second. */
+        Replay
+    };
+    ProgressMode progressMode = ProgressMode::Realtime;
+    /** Replay speed, in solver steps per second. */
+    int replaySpeed = 200;
+    /** Fractional steps owed to the replay since the last frame. */
+    double replayCredit = 0;
+    /** Drives the progress frames (created on first use). */
+    QTimer* progressTimer = nullptr;
+    /** Time since the previous progress frame. */
+    QElapsedTimer frameClock;
+    /** Steps read in the current frame; capacity reused between frames. */
+    std::vector<SudokuSolverAlgorithm::ProgressStep> progressBuffer;
+    /** Last value of each cell in the current frame, -1 if untouched. */
+    QVector<int> frameValues;
+    /** Cells touched in the current frame. */
+    QVector<int> frameTouched;
+    /** True while the grid shows a solution returned by the solver. */
+    bool solutionShown = false;
+    /** Bumped on every grid change, to drop results computed on an old grid. */
+    quint64 editGeneration = 0;
+    /** True while a hint is being computed. */
+    bool hintPending = false;
+
+    // Member variables — history
+    /** Undo/redo groups of the grid edits. */
+    EditHistory history;
+    /** Steps of the last animated solve, to step through it afterwards. */
+    SolveRecording recording;
+    /** Grid when the last solve started, row-major. */
+    std::vector<uint8_t> solveStartValues;
+    /** Cells that were clues in the solver when the last solve started, row-major. */
+    std::vector<uint8_t> solveStartGiven;
+    /** Edit generation of the grid showing the recorded solve. */
+    quint64 recordingGeneration = 0;
+
+    // Member variables — session
+    /** Session file, written in the background. */
+    SessionStore session;
+    /** Periodic autosave. */
+    QTimer* autosaveTimer = nullptr;
+    /** Edit generation and clue lock of the last saved session. */
+    quint64 savedGeneration = 0;
+    bool savedLocked = false;
+    /** True while the window waits for a stopped solve before closing. */
+    bool closePending = false;
+
+    // Member variables — check
+    /** Menu action locking the current values as clues. */
+    QAction* lockCluesAction = nullptr;
+    /** True when the clues are locked and new values are user entries. */
+    bool cluesLocked = false;
+    /** Bumped whenever the set of clues changes. */
+    quint64 clueGeneration = 0;
+    /** Restarted on each clue change; on timeout the clues are considered stable. */
+    QTimer* clueTimer = nullptr;
+    /** Clue generation of the running speculative solve. */
+    quint64 checkRunningGeneration = 0;
+    /** Clue generation of the cached solution. */
+    quint64 checkReadyGeneration = 0;
+    /** Solutions found for the cached generation (0, 1 or 2); -1 if none cached. */
+    int checkSolutions = -1;
+    /** Cached solution of the clues, row-major. */
+    QVector<unsigned short> checkSolution;
+    /** True if the user asked for a check that waits for the speculative solve. */
+    bool checkPending = false;
 
 };
 
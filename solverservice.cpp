@@ -0,0 +1,104 @@
+#include "solverservice.h"
+
+#include <QThread>
+
+SolverService::SolverService(int threads, QObject *parent)
+    : QObject(parent)
+    , lanes(qMax(1, threads))
+{
+    for (int i = 0; i < lanes.size(); ++i) {
+        Lane &lane = lanes[i];
+        lane.thread = new QThread(this);
+
+        // il risultato torna nel thread del servizio come evento accodato
+        lane.worker = new SolverWorker([this, i](const SolverResult &result){
+            QMetaObject::invokeMethod(this, [this, i, result](){ jobDone(i, result); }, Qt::QueuedConnection);
+        });
+        lane.worker->moveToThread(lane.thread);
+
+        lane.thread->start();
+    }
+}
+
+SolverService::~SolverService()
+{
+    cancelAll();
+
+    for (Lane &lane : lanes) {
+        lane.thread->quit();
+        lane.thread->wait();
+
+        // il ciclo di eventi è finito: deleteLater non verrebbe più eseguito
+        delete lane.worker;
+    }
+}
+
+void SolverService::submit(const SolverJob &job)
+{
+    // la nuova richiesta rende superata quella in coda dello stesso tipo
+    queue.removeIf([&](const SolverJob &queued){ return queued.kind == job.kind; });
+
+    if (job.kind != SolverJobKind::Solve)
+        for (Lane &lane : lanes)
+            if (lane.busy && lane.job.kind == job.kind)
+                lane.job.solver->requestStop();
+
+    queue.append(job);
+    dispatch();
+}
+
+void SolverService::cancel(SolverJobKind kind)
+{
+    queue.removeIf([&](const SolverJob &queued){ return queued.kind == kind; });
+
+    for (Lane &lane : lanes)
+        if (lane.busy && lane.job.kind == kind)
+            lane.job.solver->requestStop();
+}
+
+void SolverService::cancelAll()
+{
+    queue.clear();
+
+    for (Lane &lane : lanes)
+        if (lane.busy)
+            lane.job.solver->requestStop();
+}
+
+bool SolverService::isBusy(SolverJobKind kind) const
+{
+    for (const SolverJob &queued : queue)
+        if (queued.kind == kind) return true;
+
+    for (const Lane &lane : lanes)
+        if (lane.busy && lane.job.kind == kind) return true;
+
+    return false;
+}
+
+void SolverService::dispatch()
+{
+    for (Lane &lane : lanes) {
+        if (queue.isEmpty()) return;
+        if (lane.busy) continue;
+
+        lane.busy = true;
+        lane.job = queue.takeFirst();
+
+        // eseguito nel thread della corsia, dal suo ciclo di eventi
+        SolverWorker *worker = lane.worker;
+        const SolverJob job = lane.job;
+        QMetaObject::invokeMethod(worker, [worker, job](){ worker->run(job); }, Qt::QueuedConnection);
+    }
+}
+
+void SolverService::jobDone(int index, const SolverResult &result)
+{
+    Lane &lane = lanes[index];
+    lane.busy = false;
+    lane.job = SolverJob();
+
+    // prima si riempie la corsia libera, poi si consegna il risultato
+    dispatch();
+    emit finished(result);
+}
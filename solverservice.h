@@ -0,0 +1,79 @@
+#ifndef SOLVERSERVICE_H
+#define SOLVERSERVICE_H
+
+#include <QObject>
+#include <QList>
+#include <QVector>
+
+#include "solverworker.h"
+
+class QThread;
+
+/**
+ * @brief Long-lived pool of solver threads fed by a job queue.
+ *
+ * The threads are started once, with the service, and wait for work in their
+ * event loop: a request only queues a job, it never creates a thread nor waits
+ * for one. Results are delivered through `finished` on the thread that owns the
+ * service (the GUI thread).
+ *
+ * A new job replaces the queued job of the same kind, so a burst of requests
+ * (e.g. a check after every keystroke) runs only the last one. Except for
+ * Solve, a newer job also asks the running job of its kind to stop.
+ */
+class SolverService : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Starts the worker threads.
+     * @param threads Number of threads; two let hints and checks run during a solve.
+     * @param parent Optional parent object.
+     */
+    explicit SolverService(int threads = 2, QObject *parent = nullptr);
+    /**
+     * @brief Stops the running jobs and joins the threads.
+     */
+    ~SolverService() override;
+
+    /**
+     * @brief Queues a job, replacing a queued job of the same kind.
+     * @param job Job to run; its solver is shared with the worker until it ends.
+     */
+    void submit(const SolverJob &job);
+    /**
+     * @brief Drops the queued job of a kind and asks the running ones to stop.
+     *
+     * A stopped job still reports its (partial) result.
+     */
+    void cancel(SolverJobKind kind);
+    /** @brief Cancels every job, queued or running. */
+    void cancelAll();
+    /** @brief true if a job of this kind is queued or running. */
+    [[nodiscard]] bool isBusy(SolverJobKind kind) const;
+
+signals:
+    /** @brief A job ended; emitted on the service's thread. */
+    void finished(const SolverResult &result);
+
+private:
+    /** One thread of the pool with its worker and current job. */
+    struct Lane {
+        QThread *thread = nullptr;
+        SolverWorker *worker = nullptr;
+        bool busy = false;
+        SolverJob job;
+    };
+
+    /** @brief Hands queued jobs to idle threads, oldest first. */
+    void dispatch();
+    /** @brief Called on the service's thread when a lane ends its job. */
+    void jobDone(int lane, const SolverResult &result);
+
+    QVector<Lane> lanes;
+    /** Jobs waiting for a thread, at most one per kind. */
+    QList<SolverJob> queue;
+};
+
+#endif // SOLVERSERVICE_H
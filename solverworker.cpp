@@ -1,13 +1,44 @@
 #include "solverworker.h"
-#include "libs/SudokuSolverAlgorithm.h"
 
-SolverWorker::SolverWorker(SudokuSolverAlgorithm* s)
-    : solver(s)
+SolverWorker::SolverWorker(Done d)
+    : done(std::move(d))
 {
 }
 
-void SolverWorker::run()
+void SolverWorker::run(const SolverJob& job)
 {
-    bool ok = solver->solve();
-    emit finished(ok);
+    SolverResult result;
+    result.kind = job.kind;
+    result.tag = job.tag;
+
+    SudokuSolverAlgorithm* solver = job.solver.get();
+
+    switch (job.kind) {
+    case SolverJobKind::Solve:
+        // una risoluzione fermata (es. alla chiusura) riprende da dove era arrivata
+        result.solved = solver->canResume() ? solver->resume() == 1 : solver->solve();
+        break;
+
+    case SolverJobKind::Hint:
+        result.hint = solver->findHint(job.budget);
+        break;
+
+    case SolverJobKind::Check: {
+        result.solutions = solver->countSolutions(2);
+
+        // la griglia del solver contiene la prima soluzione trovata
+        if (result.solutions > 0) {
+            const unsigned short dimension = solver->size();
+            result.grid.resize(dimension * dimension);
+            solver->store({result.grid.data(), static_cast<size_t>(result.grid.size())});
+        }
+        break;
+    }
+
+    case SolverJobKind::Count:
+        result.solutions = solver->countSolutions(job.limit);
+        break;
+    }
+
+    done(result);
 }
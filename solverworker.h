@@ -3,23 +3,51 @@
 
 #pragma once
 #include <QObject>
+#include <QVector>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+#include "libs/SudokuSolverAlgorithm.h"
+
+// Tipo di lavoro eseguito dal servizio di risoluzione
+enum class SolverJobKind {
+    Solve,  // risolve la griglia del solver (o riprende quella fermata), con i passi per l'animazione
+    Hint,   // cerca un suggerimento
+    Check,  // conta fino a 2 soluzioni e restituisce la prima
+    Count   // conta le soluzioni fino a un limite
+};
 
-class SudokuSolverAlgorithm;
+// Richiesta al servizio: il solver è condiviso, così resta vivo finché serve al thread
+struct SolverJob {
+    SolverJobKind kind = SolverJobKind::Solve;
+    quint64 tag = 0;                     // restituito col risultato (es. una generazione)
+    std::shared_ptr<SudokuSolverAlgorithm> solver;
+    unsigned long limit = 2;             // Count: soluzioni da cercare
+    std::chrono::microseconds budget{8000}; // Hint: tempo massimo
+};
 
+struct SolverResult {
+    SolverJobKind kind = SolverJobKind::Solve;
+    quint64 tag = 0;
+    bool solved = false;                 // Solve
+    unsigned long solutions = 0;         // Check, Count
+    SudokuSolverAlgorithm::Hint hint;    // Hint
+    QVector<unsigned short> grid;        // Check: prima soluzione, riga per riga
+};
+
+// Esegue i lavori nel thread in cui vive; un worker per thread del servizio
 class SolverWorker : public QObject {
     Q_OBJECT
 public:
-    SolverWorker(SudokuSolverAlgorithm* solver);
+    using Done = std::function<void(const SolverResult&)>;
 
-public slots:
-    void run();  // eseguito nel thread
+    explicit SolverWorker(Done done);
 
-signals:
-    void finished(bool result);
+    void run(const SolverJob& job);  // eseguito nel thread
 
 private:
-    SudokuSolverAlgorithm* solver;
+    Done done;
 };
 
-
 #endif // SOLVERWORKER_H
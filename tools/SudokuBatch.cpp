@@ -0,0 +1,680 @@
+/**
+ * @file SudokuBatch.cpp
+ * @brief Batch runner: solves a large corpus in separate worker processes.
+ *
+ * Each worker is a forked process, so a puzzle that never finishes, runs out
+ * of memory or crashes the solver only costs that worker: the runner kills or
+ * reaps it, writes a status line for the puzzle and starts a new worker that
+ * carries on with the rest of the shard.
+ *
+ * Input: one puzzle per line, one symbol per cell ('.' or '0' empty); blank
+ * lines and lines starting with '#' are skipped. The dimension follows from
+ * the line length (81 for 9x9). Output: one line per puzzle, in input order,
+ * with the solved grid or `NOSOLUTION`, `INVALID`, `TIMEOUT`, `OUTOFMEMORY`,
+ * `CRASHED`.
+ *
+ * The input is memory-mapped before forking, so every worker reads the same
+ * pages. It is cut into shards of about `--shard-size` KiB at line
+ * boundaries; workers take the next shard from a counter in shared memory
+ * and write its answers to `<output>.part<N>`, flushing every 64 KiB. The
+ * runner appends finished shards to the output in order and, after each one,
+ * records the committed shard and output length in `<output>.progress`.
+ *
+ * A restarted worker resumes its shard after the last complete line of the
+ * part file. The same happens with `--resume`: the output is cut back to the
+ * last committed shard and the shards after it continue from their part
+ * files, so a run stopped for any reason loses at most the unflushed lines.
+ *
+ * Usage: SudokuBatch [--workers N] [--timeout MS] [--shard-size KB] [--memory MB] [--resume] INPUT OUTPUT
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+#include "../libs/SolverPool.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t noShard = UINT64_MAX;
+constexpr size_t flushBytes = 64 * 1024;
+constexpr char progressMagic[] = "SDKB";
+constexpr int progressVersion = 1;
+
+/** Uscite dei worker: il padre distingue la memoria esaurita dagli errori di I/O, che fermano tutto */
+constexpr int exitOutOfMemory = 3;
+constexpr int exitIoError = 4;
+constexpr int maxIdleRestarts = 3;
+
+struct Options {
+    unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+    std::chrono::milliseconds timeout{10000};
+    uint64_t shardBytes = 1u << 20;
+    /** Limite di spazio di indirizzamento per worker, 0 senza limite */
+    uint64_t memoryBytes = 0;
+    bool resume = false;
+    std::string input;
+    std::string output;
+};
+
+enum class SkipStatus : uint8_t { Timeout, OutOfMemory, Crashed };
+
+/** Stato di un worker in memoria condivisa: lo scrive il worker, il padre lo legge per scadenze e riavvii */
+struct WorkerSlot {
+    std::atomic<uint64_t> shard{noShard};
+    /** Indice nel frammento del puzzle in corso */
+    std::atomic<uint64_t> puzzle{0};
+    /** Inizio del puzzle in corso (steady_clock, comune a tutti i processi), 0 se non risolve */
+    std::atomic<int64_t> startedNs{0};
+    /** Puzzle finiti da questo slot, riavvii compresi: serve solo a riconoscere i riavvii a vuoto */
+    std::atomic<uint64_t> completed{0};
+
+    // Scritti dal padre prima di avviare il worker: il puzzle che ha ucciso il precedente
+    uint64_t skipShard = noShard;
+    uint64_t skipPuzzle = 0;
+    SkipStatus skipStatus = SkipStatus::Crashed;
+};
+
+/** Coda di lavoro condivisa: prossimo frammento da prendere e frammenti finiti */
+struct SharedState {
+    std::atomic<uint64_t> nextShard{0};
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "atomics must work across processes");
+
+/** Corpus mappato in memoria e diviso in frammenti ai confini di riga */
+struct Corpus {
+    const char *data = nullptr;
+    uint64_t size = 0;
+    uint64_t shardBytes = 0;
+
+    [[nodiscard]] uint64_t shardCount() const { return (size + shardBytes - 1) / shardBytes; }
+
+    /** Primo inizio riga a partire da `position`: ogni riga appartiene al frammento in cui inizia */
+    [[nodiscard]] uint64_t lineStart(uint64_t position) const {
+        if (position == 0 || position >= size)
+            return std::min(position, size);
+        const void *newline = std::memchr(data + position - 1, '\n', size - position + 1);
+        return newline ? static_cast<uint64_t>(static_cast<const char*>(newline) - data) + 1 : size;
+    }
+
+    [[nodiscard]] std::string_view shard(uint64_t index) const {
+        const uint64_t begin = lineStart(index * shardBytes);
+        const uint64_t end = lineStart((index + 1) * shardBytes);
+        return {data + begin, end - begin};
+    }
+};
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+std::string partPath(const Options &options, uint64_t shard) {
+    return options.output + ".part" + std::to_string(shard);
+}
+
+std::string progressPath(const Options &options) {
+    return options.output + ".progress";
+}
+
+bool writeAll(int fd, const char *data, size_t length) {
+    while (length > 0) {
+        const ssize_t written = ::write(fd, data, length);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return false;
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+const char *skipLine(SkipStatus status) {
+    switch (status) {
+    case SkipStatus::Timeout: return "TIMEOUT\n";
+    case SkipStatus::OutOfMemory: return "OUTOFMEMORY\n";
+    case SkipStatus::Crashed: return "CRASHED\n";
+    }
+    return "CRASHED\n";
+}
+
+/** Riga del corpus ripulita; vuota se va saltata (vuota o commento) */
+std::string_view puzzleLine(std::string_view line) {
+    while (!line.empty() && std::strchr(" \t\r", line.back()))
+        line.remove_suffix(1);
+    while (!line.empty() && std::strchr(" \t", line.front()))
+        line.remove_prefix(1);
+    return !line.empty() && line.front() == '#' ? std::string_view() : line;
+}
+
+/** Risolve un puzzle e ne accoda la riga di risposta */
+void solveLine(std::string_view grid, SolverPool &pool, std::vector<unsigned short> &values, std::string &out) {
+    const auto dimension = static_cast<unsigned short>(std::lround(std::sqrt(static_cast<double>(grid.size()))));
+    const auto block = static_cast<unsigned short>(std::lround(std::sqrt(static_cast<double>(dimension))));
+    if (dimension == 0 || dimension > 36 || static_cast<size_t>(dimension) * dimension != grid.size()
+        || block * block != dimension) {
+        out += "INVALID\n";
+        return;
+    }
+
+    SolverPool::Handle solver = pool.acquire(dimension);
+    solver->setProgressRecording(false);
+    if (!solver->loadFromString(grid).empty()) {
+        out += "INVALID\n";
+        return;
+    }
+    if (!solver->solve()) {
+        out += "NOSOLUTION\n";
+        return;
+    }
+
+    values.resize(grid.size());
+    solver->store(values);
+    for (const unsigned short value : values)
+        out += SudokuSolverAlgorithm::symbolFor(value);
+    out += '\n';
+}
+
+/*
+ * Processo worker: finisce il frammento che aveva il worker precedente, poi prende i successivi dalla coda.
+ * Non ritorna mai: esce con 0 a coda vuota.
+ */
+[[noreturn]] void runWorker(const Options &options, const Corpus &corpus, SharedState &shared,
+                            WorkerSlot &slot, std::atomic<uint8_t> *shardDone) {
+#ifdef __linux__
+    // Se il padre muore i worker non restano orfani a consumare CPU
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() == 1)
+        _exit(exitIoError);
+#endif
+    if (options.memoryBytes > 0) {
+        const rlimit limit{static_cast<rlim_t>(options.memoryBytes), static_cast<rlim_t>(options.memoryBytes)};
+        setrlimit(RLIMIT_AS, &limit);
+    }
+
+    uint64_t shard = slot.shard.load();
+    if (shard == noShard)
+        shard = shared.nextShard.fetch_add(1);
+
+    try {
+        SolverPool pool;
+        std::vector<unsigned short> values;
+        std::string out;
+        out.reserve(flushBytes + 8192);
+
+        while (shard < corpus.shardCount()) {
+            slot.shard = shard;
+            // Riavviato dopo aver chiuso il frammento: il padre può averlo già unito e cancellato
+            if (shardDone[shard].load()) {
+                shard = shared.nextShard.fetch_add(1);
+                continue;
+            }
+
+            // Le righe complete nel file parziale sono i puzzle già fatti; il resto si riscrive
+            const std::string path = partPath(options, shard);
+            const int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            if (fd < 0)
+                _exit(exitIoError);
+            uint64_t done = 0;
+            off_t keep = 0;
+            {
+                char buffer[65536];
+                off_t position = 0;
+                ssize_t got;
+                while ((got = ::read(fd, buffer, sizeof buffer)) > 0) {
+                    for (ssize_t i = 0; i < got; i++) {
+                        if (buffer[i] == '\n') {
+                            done++;
+                            keep = position + i + 1;
+                        }
+                    }
+                    position += got;
+                }
+                if (got < 0 || ::ftruncate(fd, keep) != 0 || ::lseek(fd, keep, SEEK_SET) != keep)
+                    _exit(exitIoError);
+            }
+
+            const std::string_view text = corpus.shard(shard);
+            uint64_t index = 0;
+            size_t at = 0;
+            while (at < text.size()) {
+                size_t next = text.find('\n', at);
+                if (next == std::string_view::npos)
+                    next = text.size();
+                const std::string_view grid = puzzleLine(text.substr(at, next - at));
+                at = next + 1;
+                if (grid.empty())
+                    continue;
+                if (index++ < done)
+                    continue;
+
+                const uint64_t puzzle = index - 1;
+                if (slot.skipShard == shard && slot.skipPuzzle == puzzle) {
+                    // Subito su disco: un altro riavvio nello stesso frammento non lo ritenta
+                    out += skipLine(slot.skipStatus);
+                    if (!writeAll(fd, out.data(), out.size()))
+                        _exit(exitIoError);
+                    out.clear();
+                } else {
+                    slot.puzzle = puzzle;
+                    slot.startedNs = nowNs();
+                    solveLine(grid, pool, values, out);
+                    slot.startedNs = 0;
+                }
+                slot.completed.fetch_add(1, std::memory_order_relaxed);
+
+                if (out.size() >= flushBytes) {
+                    if (!writeAll(fd, out.data(), out.size()))
+                        _exit(exitIoError);
+                    out.clear();
+                }
+            }
+
+            if (!writeAll(fd, out.data(), out.size()) || ::fdatasync(fd) != 0 || ::close(fd) != 0)
+                _exit(exitIoError);
+            out.clear();
+            shardDone[shard].store(1);
+            shard = shared.nextShard.fetch_add(1);
+        }
+    } catch (const std::bad_alloc &) {
+        _exit(exitOutOfMemory);
+    }
+
+    slot.shard = noShard;
+    _exit(0);
+}
+
+/** Esecuzione completa lato padre: avvio dei worker, scadenze, riavvii e unione ordinata */
+class Runner {
+public:
+    explicit Runner(Options options) : options(std::move(options)) {}
+    ~Runner();
+
+    int run();
+
+private:
+    bool mapInput();
+    bool openOutput();
+    bool writeProgress();
+    bool mergeReady();
+    pid_t startWorker(size_t index);
+    /** Un worker terminato: false se l'errore ferma tutta l'esecuzione */
+    bool workerExited(size_t index, int status);
+    void checkTimeouts();
+
+    Options options;
+    Corpus corpus;
+    int inputFd = -1;
+    int outputFd = -1;
+
+    void *sharedMemory = MAP_FAILED;
+    size_t sharedSize = 0;
+    SharedState *shared = nullptr;
+    WorkerSlot *slots = nullptr;
+    std::atomic<uint8_t> *shardDone = nullptr;
+
+    std::vector<pid_t> pids;
+    /** Worker uccisi per la scadenza: frammento e puzzle da saltare al riavvio */
+    std::vector<uint64_t> killedShard;
+    std::vector<uint64_t> killedPuzzle;
+    /** Riavvii consecutivi senza puzzle completati, per non ripartire in loop */
+    std::vector<int> idleRestarts;
+    std::vector<uint64_t> restartMark;
+
+    uint64_t merged = 0;
+    uint64_t outputBytes = 0;
+    /** Righe unite all'uscita in questa esecuzione: un puzzle risolto due volte conta una */
+    uint64_t puzzles = 0;
+    uint64_t timeouts = 0;
+    uint64_t failures = 0;
+};
+
+Runner::~Runner() {
+    for (const pid_t pid : pids) {
+        if (pid > 0) {
+            ::kill(pid, SIGKILL);
+            ::waitpid(pid, nullptr, 0);
+        }
+    }
+    if (sharedMemory != MAP_FAILED)
+        ::munmap(sharedMemory, sharedSize);
+    if (corpus.data)
+        ::munmap(const_cast<char*>(corpus.data), corpus.size);
+    if (inputFd >= 0)
+        ::close(inputFd);
+    if (outputFd >= 0)
+        ::close(outputFd);
+}
+
+bool Runner::mapInput() {
+    inputFd = ::open(options.input.c_str(), O_RDONLY);
+    struct stat info {};
+    if (inputFd < 0 || ::fstat(inputFd, &info) != 0) {
+        std::fprintf(stderr, "%s: %s\n", options.input.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    corpus.size = static_cast<uint64_t>(info.st_size);
+    corpus.shardBytes = options.shardBytes;
+    if (corpus.size == 0)
+        return true;
+
+    void *data = ::mmap(nullptr, corpus.size, PROT_READ, MAP_PRIVATE, inputFd, 0);
+    if (data == MAP_FAILED) {
+        std::fprintf(stderr, "%s: %s\n", options.input.c_str(), std::strerror(errno));
+        return false;
+    }
+    ::madvise(data, corpus.size, MADV_SEQUENTIAL);
+    corpus.data = static_cast<const char*>(data);
+    return true;
+}
+
+/*
+ * Apre l'uscita. Con --resume riparte dall'ultimo frammento registrato; un file di avanzamento
+ * di un altro corpus è un errore. Senza --resume, o senza file di avanzamento, ricomincia da capo
+ * scartando i file parziali.
+ */
+bool Runner::openOutput() {
+    bool resumed = false;
+    if (options.resume) {
+        if (FILE *progress = std::fopen(progressPath(options).c_str(), "r")) {
+            char magic[8] = {};
+            int version = 0;
+            unsigned long long inputSize = 0, shardBytes = 0, shards = 0, bytes = 0;
+            const bool parsed = std::fscanf(progress, "%7s %d %llu %llu %llu %llu", magic, &version,
+                                            &inputSize, &shardBytes, &shards, &bytes) == 6;
+            std::fclose(progress);
+            if (!parsed || std::strcmp(magic, progressMagic) != 0 || version != progressVersion
+                || inputSize != corpus.size || shardBytes == 0) {
+                std::fprintf(stderr, "%s: does not match %s, cannot resume\n",
+                             progressPath(options).c_str(), options.input.c_str());
+                return false;
+            }
+            // I confini dei frammenti devono restare quelli della prima esecuzione
+            corpus.shardBytes = shardBytes;
+            merged = std::min<uint64_t>(shards, corpus.shardCount());
+            outputBytes = bytes;
+            resumed = true;
+        }
+    }
+
+    outputFd = ::open(options.output.c_str(), O_WRONLY | O_CREAT, 0644);
+    if (outputFd < 0 || ::ftruncate(outputFd, static_cast<off_t>(outputBytes)) != 0
+        || ::lseek(outputFd, static_cast<off_t>(outputBytes), SEEK_SET) < 0) {
+        std::fprintf(stderr, "%s: %s\n", options.output.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    if (!resumed) {
+        for (uint64_t shard = 0; shard < corpus.shardCount(); shard++)
+            ::unlink(partPath(options, shard).c_str());
+    }
+    return writeProgress();
+}
+
+/** Registra i frammenti uniti: file temporaneo e rename, così non resta mai a metà */
+bool Runner::writeProgress() {
+    const std::string path = progressPath(options);
+    const std::string temporary = path + ".tmp";
+    FILE *progress = std::fopen(temporary.c_str(), "w");
+    if (!progress)
+        return false;
+    std::fprintf(progress, "%s %d %llu %llu %llu %llu\n", progressMagic, progressVersion,
+                 static_cast<unsigned long long>(corpus.size), static_cast<unsigned long long>(corpus.shardBytes),
+                 static_cast<unsigned long long>(merged), static_cast<unsigned long long>(outputBytes));
+    const bool written = std::fflush(progress) == 0 && ::fsync(fileno(progress)) == 0;
+    return std::fclose(progress) == 0 && written && std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+/*
+ * Accoda all'uscita i frammenti finiti contigui al già unito.
+ * L'uscita va su disco prima del file di avanzamento: un frammento registrato non si perde.
+ */
+bool Runner::mergeReady() {
+    std::vector<char> buffer;
+    while (merged < corpus.shardCount() && shardDone[merged].load()) {
+        const std::string path = partPath(options, merged);
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::fprintf(stderr, "%s: %s\n", path.c_str(), std::strerror(errno));
+            return false;
+        }
+        buffer.resize(1u << 20);
+        ssize_t got;
+        while ((got = ::read(fd, buffer.data(), buffer.size())) > 0) {
+            if (!writeAll(outputFd, buffer.data(), static_cast<size_t>(got))) {
+                ::close(fd);
+                std::fprintf(stderr, "%s: %s\n", options.output.c_str(), std::strerror(errno));
+                return false;
+            }
+            outputBytes += static_cast<uint64_t>(got);
+            puzzles += static_cast<uint64_t>(std::count(buffer.data(), buffer.data() + got, '\n'));
+        }
+        ::close(fd);
+        if (got < 0)
+            return false;
+
+        merged++;
+        if (::fdatasync(outputFd) != 0 || !writeProgress())
+            return false;
+        ::unlink(path.c_str());
+    }
+    return true;
+}
+
+pid_t Runner::startWorker(size_t index) {
+    std::fflush(nullptr);
+    const pid_t pid = ::fork();
+    if (pid == 0)
+        runWorker(options, corpus, *shared, slots[index], shardDone);
+    pids[index] = pid;
+    return pid;
+}
+
+bool Runner::workerExited(size_t index, int status) {
+    pids[index] = 0;
+    WorkerSlot &slot = slots[index];
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+        return true;
+    if (WIFEXITED(status) && WEXITSTATUS(status) == exitIoError) {
+        std::fprintf(stderr, "worker %zu: cannot write %s\n", index,
+                     partPath(options, slot.shard.load()).c_str());
+        return false;
+    }
+
+    // Il puzzle in corso non si ritenta: il worker nuovo scrive lo stato al suo posto e va avanti
+    if (killedShard[index] != noShard) {
+        slot.skipShard = killedShard[index];
+        slot.skipPuzzle = killedPuzzle[index];
+        slot.skipStatus = SkipStatus::Timeout;
+        killedShard[index] = noShard;
+    } else if (slot.startedNs.load() != 0) {
+        slot.skipShard = slot.shard.load();
+        slot.skipPuzzle = slot.puzzle.load();
+        slot.skipStatus = WIFEXITED(status) && WEXITSTATUS(status) == exitOutOfMemory
+                              ? SkipStatus::OutOfMemory : SkipStatus::Crashed;
+        failures++;
+    } else {
+        // Morto fuori da un puzzle (ucciso da fuori, I/O): si riavvia, ma non all'infinito senza progressi
+        const uint64_t completed = slot.completed.load();
+        idleRestarts[index] = completed == restartMark[index] ? idleRestarts[index] + 1 : 0;
+        restartMark[index] = completed;
+        if (idleRestarts[index] >= maxIdleRestarts) {
+            std::fprintf(stderr, "worker %zu: terminated %d times without progress (%s %d)\n", index, maxIdleRestarts,
+                         WIFSIGNALED(status) ? "signal" : "exit code",
+                         WIFSIGNALED(status) ? WTERMSIG(status) : WEXITSTATUS(status));
+            return false;
+        }
+        failures++;
+    }
+    slot.startedNs = 0;
+
+    if (startWorker(index) < 0) {
+        std::fprintf(stderr, "fork: %s\n", std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Uccide i worker fermi da troppo sullo stesso puzzle.
+ * Il puzzle si legge prima e dopo l'inizio: se cambia, il worker è già andato avanti.
+ */
+void Runner::checkTimeouts() {
+    const int64_t now = nowNs();
+    const int64_t limit = std::chrono::duration_cast<std::chrono::nanoseconds>(options.timeout).count();
+    for (size_t i = 0; i < pids.size(); i++) {
+        if (pids[i] <= 0 || killedShard[i] != noShard)
+            continue;
+        const uint64_t puzzle = slots[i].puzzle.load();
+        const int64_t started = slots[i].startedNs.load();
+        const uint64_t shard = slots[i].shard.load();
+        if (started == 0 || now - started < limit || slots[i].puzzle.load() != puzzle)
+            continue;
+
+        killedShard[i] = shard;
+        killedPuzzle[i] = puzzle;
+        timeouts++;
+        ::kill(pids[i], SIGKILL);
+    }
+}
+
+int Runner::run() {
+    const auto begin = Clock::now();
+    if (!mapInput() || !openOutput())
+        return 1;
+
+    const uint64_t shards = corpus.shardCount();
+    const size_t workers = static_cast<size_t>(std::max<uint64_t>(1, std::min<uint64_t>(options.workers, shards - merged)));
+
+    // Coda, stato dei worker e frammenti finiti in una mappatura anonima condivisa con i figli
+    sharedSize = sizeof(SharedState) + workers * sizeof(WorkerSlot) + shards;
+    sharedMemory = ::mmap(nullptr, sharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (sharedMemory == MAP_FAILED) {
+        std::fprintf(stderr, "mmap: %s\n", std::strerror(errno));
+        return 1;
+    }
+    auto *bytes = static_cast<unsigned char*>(sharedMemory);
+    shared = new (bytes) SharedState;
+    shared->nextShard = merged;
+    slots = reinterpret_cast<WorkerSlot*>(bytes + sizeof(SharedState));
+    for (size_t i = 0; i < workers; i++)
+        new (&slots[i]) WorkerSlot;
+    shardDone = reinterpret_cast<std::atomic<uint8_t>*>(bytes + sizeof(SharedState) + workers * sizeof(WorkerSlot));
+    for (uint64_t shard = 0; shard < shards; shard++)
+        new (&shardDone[shard]) std::atomic<uint8_t>(0);
+
+    pids.assign(workers, 0);
+    killedShard.assign(workers, noShard);
+    killedPuzzle.assign(workers, 0);
+    idleRestarts.assign(workers, 0);
+    restartMark.assign(workers, 0);
+    if (merged < shards) {
+        for (size_t i = 0; i < workers; i++) {
+            if (startWorker(i) < 0) {
+                std::fprintf(stderr, "fork: %s\n", std::strerror(errno));
+                return 1;
+            }
+        }
+    }
+
+    while (merged < shards) {
+        int status = 0;
+        pid_t pid;
+        while ((pid = ::waitpid(-1, &status, WNOHANG)) > 0) {
+            const auto found = std::find(pids.begin(), pids.end(), pid);
+            if (found != pids.end() && !workerExited(static_cast<size_t>(found - pids.begin()), status))
+                return 1;
+        }
+        checkTimeouts();
+        if (!mergeReady())
+            return 1;
+
+        // Tutti usciti con frammenti ancora da unire: non dovrebbe succedere, ma non si aspetta per sempre
+        if (merged < shards && std::all_of(pids.begin(), pids.end(), [](pid_t p) { return p <= 0; })) {
+            std::fprintf(stderr, "workers exited with %llu shards left\n", static_cast<unsigned long long>(shards - merged));
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    for (pid_t &pid : pids) {
+        if (pid > 0)
+            ::waitpid(pid, nullptr, 0);
+        pid = 0;
+    }
+    // Uscita completa: il file di avanzamento non serve più
+    ::unlink(progressPath(options).c_str());
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    std::fprintf(stderr, "%llu puzzles in %.1f s (%.0f/s), %zu workers, %llu timeouts, %llu crashes\n",
+                 static_cast<unsigned long long>(puzzles), seconds, seconds > 0 ? puzzles / seconds : 0.0,
+                 workers, static_cast<unsigned long long>(timeouts), static_cast<unsigned long long>(failures));
+    return 0;
+}
+
+void usage(const char *program) {
+    std::fprintf(stderr, "usage: %s [--workers N] [--timeout MS] [--shard-size KB] [--memory MB] [--resume] INPUT OUTPUT\n",
+                 program);
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        const std::string flag = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (flag == "--resume")
+            options.resume = true;
+        else if (flag == "--workers" && hasValue)
+            options.workers = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        else if (flag == "--timeout" && hasValue)
+            options.timeout = std::chrono::milliseconds(std::max(1, std::atoi(argv[++i])));
+        else if (flag == "--shard-size" && hasValue)
+            options.shardBytes = static_cast<uint64_t>(std::max(1, std::atoi(argv[++i]))) * 1024;
+        else if (flag == "--memory" && hasValue)
+            options.memoryBytes = static_cast<uint64_t>(std::max(0, std::atoi(argv[++i]))) << 20;
+        else if (flag.starts_with("--")) {
+            usage(argv[0]);
+            return 2;
+        } else
+            files.push_back(flag);
+    }
+    if (files.size() != 2) {
+        usage(argv[0]);
+        return 2;
+    }
+    options.input = files[0];
+    options.output = files[1];
+
+    Runner runner(std::move(options));
+    return runner.run();
+}
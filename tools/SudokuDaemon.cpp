@@ -0,0 +1,670 @@
+/**
+ * @file SudokuDaemon.cpp
+ * @brief Local solver daemon: solves puzzles sent over a Unix domain socket.
+ *
+ * One process keeps a pool of solvers warm and serves any number of clients,
+ * instead of one process per puzzle. Requests are pipelined: a client may send
+ * many before reading any answer, and answers come back as they finish, tagged
+ * with the request id (so possibly out of order).
+ *
+ * Text protocol, one request per line:
+ *
+ *     <id> <grid> [deadline-ms]    grid: one symbol per cell ('.' or '0' empty)
+ *     STATS                        one line of counters (see below)
+ *
+ * answered with `<id> OK <solved grid>`, `<id> NOSOLUTION`, `<id> TIMEOUT`,
+ * `<id> INVALID`. The dimension follows from the grid length (81 for 9x9).
+ *
+ * Binary protocol, for states written by `SudokuSolverAlgorithm::serialize()`:
+ *
+ *     request:  0x00, id (u32), deadline-ms (u32), length (u32), state
+ *     answer:   0x00, id (u32), status (u8), length (u32), solved state
+ *
+ * little-endian, status 0 OK, 1 NOSOLUTION, 2 TIMEOUT, 3 INVALID. Text and
+ * binary requests can be mixed on one connection.
+ *
+ * The I/O thread parses requests into a bounded queue; worker threads take
+ * them in small batches and solve them on solvers from a SolverPool. When the
+ * queue is full the daemon stops reading from the sockets, so clients block
+ * in `write()` instead of the daemon buffering without limit; the same
+ * happens to a client that does not read its answers. A request still queued
+ * at its deadline is answered TIMEOUT without solving; a running one is
+ * stopped.
+ *
+ * STATS answers `STATS queue=.. running=.. connections=.. received=..
+ * completed=.. timeouts=.. rate=../s p50=..ms p90=..ms p99=..ms max=..ms`,
+ * the rate over the last 10 s and the latencies (receive to answer) over the
+ * last 8192 requests.
+ *
+ * Usage: SudokuDaemon [--socket PATH] [--threads N] [--queue N] [--batch N] [--deadline MS]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../libs/SolverPool.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum class Status : uint8_t { Solved = 0, NoSolution = 1, Timeout = 2, Invalid = 3 };
+
+constexpr uint8_t binaryTag = 0x00;
+constexpr size_t binaryHeader = 1 + 4 + 4 + 4;
+/** Uno stato serializzato più grande non è un sudoku: la connessione si chiude */
+constexpr uint32_t maxBinaryLength = 1u << 20;
+constexpr size_t maxLineLength = 8192;
+/** Oltre queste soglie (richieste non ancora in coda, risposte non lette) la connessione non si legge */
+constexpr size_t inputLimit = 1u << 20;
+constexpr size_t outputLimit = 1u << 20;
+constexpr size_t latencyWindow = 8192;
+constexpr int rateSeconds = 10;
+
+struct Options {
+    std::string socketPath = "/tmp/sudoku-solver.sock";
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t queueCapacity = 1024;
+    size_t batch = 16;
+    std::chrono::milliseconds deadline{5000};
+};
+
+struct Job {
+    /** Connessione di provenienza: numero progressivo, mai riusato */
+    uint64_t connection = 0;
+    bool binary = false;
+    /** Id del cliente: testo così com'è, oppure u32 del formato binario */
+    std::string textId;
+    uint32_t binaryId = 0;
+    unsigned short dimension = 0;
+    std::string grid;
+    std::vector<uint8_t> state;
+    Clock::time_point received;
+    Clock::time_point deadline;
+
+    Status status = Status::Invalid;
+    /** Risposta: griglia risolta (testo) o stato risolto (binario) */
+    std::string solvedGrid;
+    std::vector<uint8_t> solvedState;
+};
+
+/** Coda condivisa fra il thread di I/O e i worker */
+struct Queue {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::unique_ptr<Job>> pending;
+    std::vector<std::unique_ptr<Job>> done;
+    bool stopping = false;
+    size_t running = 0;
+};
+
+/** Il lavoro in corso su un worker, per fermarlo alla scadenza */
+struct Slot {
+    std::mutex mutex;
+    SudokuSolverAlgorithm *solver = nullptr;
+    Clock::time_point deadline;
+    bool stopIssued = false;
+};
+
+struct Connection {
+    int fd = -1;
+    uint64_t serial = 0;
+    std::string in;
+    std::string out;
+    size_t inFlight = 0;
+    /** Il cliente ha chiuso in scrittura: si chiude quando ha avuto tutte le risposte */
+    bool readClosed = false;
+};
+
+struct Stats {
+    uint64_t received = 0;
+    uint64_t completed = 0;
+    uint64_t timeouts = 0;
+    std::vector<double> latencies = std::vector<double>(latencyWindow, 0.0);
+    size_t latencyCount = 0;
+    /** Risposte per secondo negli ultimi `rateSeconds` secondi, a rotazione */
+    uint64_t perSecond[rateSeconds] = {};
+    long long second[rateSeconds] = {};
+};
+
+int wakePipe[2] = {-1, -1};
+volatile std::sig_atomic_t stopSignal = 0;
+
+void onSignal(int) {
+    stopSignal = 1;
+    const char byte = 0;
+    [[maybe_unused]] const ssize_t written = write(wakePipe[1], &byte, 1);
+}
+
+void wakeLoop() {
+    const char byte = 1;
+    [[maybe_unused]] const ssize_t written = write(wakePipe[1], &byte, 1);
+}
+
+void putU32(std::string &out, uint32_t v) {
+    for (int i = 0; i < 4; i++)
+        out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+uint32_t getU32(const char *data) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++)
+        v |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    return v;
+}
+
+void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+/** Risolve un lavoro su un solver del pool; la scadenza la controlla il thread di I/O */
+void runJob(Job &job, SolverPool &pool, Slot &slot) {
+    if (Clock::now() >= job.deadline) {
+        job.status = Status::Timeout;
+        return;
+    }
+
+    SolverPool::Handle solver = pool.acquire(job.dimension);
+    solver->setProgressRecording(false);
+    if (job.binary ? !solver->deserialize(job.state) : !solver->loadFromString(job.grid).empty()) {
+        job.status = Status::Invalid;
+        return;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.solver = solver.get();
+        slot.deadline = job.deadline;
+        slot.stopIssued = false;
+    }
+    const bool solved = solver->solve();
+    bool stopped = false;
+    {
+        const std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.solver = nullptr;
+        stopped = slot.stopIssued;
+    }
+    job.status = solved ? Status::Solved : stopped ? Status::Timeout : Status::NoSolution;
+    if (solved && job.binary) {
+        solver->serialize(job.solvedState);
+    } else if (solved) {
+        const unsigned short dimension = solver->size();
+        job.solvedGrid.resize(static_cast<size_t>(dimension) * dimension);
+        std::vector<unsigned short> values(job.solvedGrid.size());
+        solver->store(values);
+        for (size_t cell = 0; cell < values.size(); cell++)
+            job.solvedGrid[cell] = SudokuSolverAlgorithm::symbolFor(values[cell]);
+    }
+}
+
+/** Un worker prende i lavori a piccoli lotti: un solo lock e un solo risveglio per lotto */
+void workerLoop(Queue &queue, SolverPool &pool, Slot &slot, const Options &options) {
+    std::vector<std::unique_ptr<Job>> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queue.mutex);
+            queue.ready.wait(lock, [&] { return queue.stopping || !queue.pending.empty(); });
+            if (queue.stopping)
+                return;
+            // Una parte equa della coda, così i lotti non lasciano fermi gli altri worker
+            const size_t share = queue.pending.size() / options.threads + 1;
+            const size_t take = std::min({options.batch, share, queue.pending.size()});
+            for (size_t i = 0; i < take; i++) {
+                batch.push_back(std::move(queue.pending.front()));
+                queue.pending.pop_front();
+            }
+            queue.running += take;
+        }
+
+        for (auto &job : batch)
+            runJob(*job, pool, slot);
+
+        {
+            const std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.running -= batch.size();
+            for (auto &job : batch)
+                queue.done.push_back(std::move(job));
+        }
+        batch.clear();
+        wakeLoop();
+    }
+}
+
+class Daemon {
+public:
+    explicit Daemon(Options options) : options(std::move(options)), slots(this->options.threads) {}
+
+    int run();
+
+private:
+    bool listenOn(const std::string &path);
+    void acceptClients();
+    /** @brief Legge dal socket; false se la connessione va chiusa subito. */
+    bool readFrom(Connection &connection);
+    /** @brief Estrae le richieste complete finché la coda ha posto; false su dati non validi. */
+    bool parseRequests(Connection &connection);
+    void enqueue(std::unique_ptr<Job> job);
+    void answer(Job &job);
+    static void writeAnswer(Connection &connection, const Job &job);
+    void collectResults();
+    void checkDeadlines();
+    std::string statsLine();
+    void noteCompletion(const Job &job);
+
+    Options options;
+    int listenFd = -1;
+    Queue queue;
+    SolverPool pool;
+    std::vector<Slot> slots;
+    std::unordered_map<uint64_t, Connection> connections;
+    uint64_t nextSerial = 1;
+    /** Lavori in coda, letti senza lock dal thread di I/O che è l'unico a inserirli */
+    size_t queued = 0;
+    Stats stats;
+};
+
+bool Daemon::listenOn(const std::string &path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::fprintf(stderr, "socket path too long: %s\n", path.c_str());
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::perror("socket");
+        return false;
+    }
+    // Un socket rimasto da un'esecuzione precedente va tolto prima di bind()
+    unlink(path.c_str());
+    if (bind(listenFd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0
+        || listen(listenFd, 128) < 0) {
+        std::perror(path.c_str());
+        return false;
+    }
+    chmod(path.c_str(), S_IRUSR | S_IWUSR);
+    setNonBlocking(listenFd);
+    return true;
+}
+
+void Daemon::acceptClients() {
+    while (true) {
+        const int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0)
+            return;
+        setNonBlocking(fd);
+        const uint64_t serial = nextSerial++;
+        Connection &connection = connections[serial];
+        connection.fd = fd;
+        connection.serial = serial;
+    }
+}
+
+bool Daemon::readFrom(Connection &connection) {
+    char buffer[16384];
+    while (true) {
+        const ssize_t n = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            connection.in.append(buffer, static_cast<size_t>(n));
+            if (connection.in.size() >= inputLimit)
+                return true;
+            continue;
+        }
+        if (n == 0) {
+            connection.readClosed = true;
+            return true;
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+}
+
+bool Daemon::parseRequests(Connection &connection) {
+    size_t at = 0;
+    while (at < connection.in.size() && queued < options.queueCapacity) {
+        const char *data = connection.in.data() + at;
+        const size_t available = connection.in.size() - at;
+        auto job = std::make_unique<Job>();
+        job->connection = connection.serial;
+        job->received = Clock::now();
+        job->deadline = job->received + options.deadline;
+
+        if (static_cast<uint8_t>(data[0]) == binaryTag) {
+            if (available < binaryHeader)
+                break;
+            const uint32_t length = getU32(data + 9);
+            if (length > maxBinaryLength)
+                return false;
+            if (available < binaryHeader + length)
+                break;
+            job->binary = true;
+            job->binaryId = getU32(data + 1);
+            if (const uint32_t ms = getU32(data + 5))
+                job->deadline = job->received + std::chrono::milliseconds(ms);
+            at += binaryHeader + length;
+            // Lo stato inizia con "SDKS", la versione e la dimensione. La dimensione sceglie il solver
+            // del pool e le sue tabelle, che restano in memoria: una non valida non arriva al pool.
+            const unsigned short dimension = length > 5 ? static_cast<uint8_t>(data[binaryHeader + 5]) : 0;
+            const auto block = static_cast<unsigned short>(std::lround(std::sqrt(static_cast<double>(dimension))));
+            if (dimension == 0 || dimension > 64 || block * block != dimension) {
+                writeAnswer(connection, *job);
+                continue;
+            }
+            job->state.assign(data + binaryHeader, data + binaryHeader + length);
+            job->dimension = dimension;
+            enqueue(std::move(job));
+            continue;
+        }
+
+        const char *end = static_cast<const char *>(std::memchr(data, '\n', available));
+        if (!end) {
+            if (available > maxLineLength)
+                return false;
+            break;
+        }
+        std::string line(data, static_cast<size_t>(end - data));
+        at += line.size() + 1;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        char id[256], grid[4200];
+        long ms = 0;
+        if (line == "STATS") {
+            connection.out += statsLine();
+            continue;
+        }
+        const int fields = std::sscanf(line.c_str(), "%255s %4199s %ld", id, grid, &ms);
+        if (fields < 2) {
+            if (fields == 1) {
+                connection.out += std::string(id) + " INVALID\n";
+            }
+            continue;
+        }
+        job->textId = id;
+        job->grid = grid;
+        if (fields == 3 && ms > 0)
+            job->deadline = job->received + std::chrono::milliseconds(ms);
+        const auto dimension = static_cast<unsigned short>(std::lround(std::sqrt(static_cast<double>(job->grid.size()))));
+        const auto block = static_cast<unsigned short>(std::lround(std::sqrt(static_cast<double>(dimension))));
+        if (dimension == 0 || dimension > 36 || static_cast<size_t>(dimension) * dimension != job->grid.size()
+            || block * block != dimension) {
+            connection.out += job->textId + " INVALID\n";
+            continue;
+        }
+        job->dimension = dimension;
+        enqueue(std::move(job));
+    }
+    connection.in.erase(0, at);
+    return true;
+}
+
+void Daemon::enqueue(std::unique_ptr<Job> job) {
+    connections[job->connection].inFlight++;
+    stats.received++;
+    queued++;
+    {
+        const std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.pending.push_back(std::move(job));
+    }
+    queue.ready.notify_one();
+}
+
+void Daemon::answer(Job &job) {
+    auto it = connections.find(job.connection);
+    if (it == connections.end())
+        return;
+    it->second.inFlight--;
+    writeAnswer(it->second, job);
+}
+
+void Daemon::writeAnswer(Connection &connection, const Job &job) {
+    if (job.binary) {
+        connection.out.push_back(static_cast<char>(binaryTag));
+        putU32(connection.out, job.binaryId);
+        connection.out.push_back(static_cast<char>(job.status));
+        putU32(connection.out, static_cast<uint32_t>(job.solvedState.size()));
+        connection.out.append(job.solvedState.begin(), job.solvedState.end());
+        return;
+    }
+
+    static const char *const names[] = {"OK", "NOSOLUTION", "TIMEOUT", "INVALID"};
+    connection.out += job.textId;
+    connection.out += ' ';
+    connection.out += names[static_cast<int>(job.status)];
+    if (job.status == Status::Solved) {
+        connection.out += ' ';
+        connection.out += job.solvedGrid;
+    }
+    connection.out += '\n';
+}
+
+void Daemon::noteCompletion(const Job &job) {
+    const auto now = Clock::now();
+    stats.completed++;
+    if (job.status == Status::Timeout)
+        stats.timeouts++;
+    stats.latencies[stats.latencyCount++ % latencyWindow] =
+        std::chrono::duration<double, std::milli>(now - job.received).count();
+
+    const long long second = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    const int slot = static_cast<int>(second % rateSeconds);
+    if (stats.second[slot] != second) {
+        stats.second[slot] = second;
+        stats.perSecond[slot] = 0;
+    }
+    stats.perSecond[slot]++;
+}
+
+void Daemon::collectResults() {
+    std::vector<std::unique_ptr<Job>> finished;
+    {
+        const std::lock_guard<std::mutex> lock(queue.mutex);
+        finished.swap(queue.done);
+        queued = queue.pending.size();
+    }
+    for (auto &job : finished) {
+        noteCompletion(*job);
+        answer(*job);
+    }
+}
+
+void Daemon::checkDeadlines() {
+    const auto now = Clock::now();
+    for (Slot &slot : slots) {
+        const std::lock_guard<std::mutex> lock(slot.mutex);
+        if (slot.solver && !slot.stopIssued && now >= slot.deadline) {
+            slot.solver->requestStop();
+            slot.stopIssued = true;
+        }
+    }
+}
+
+std::string Daemon::statsLine() {
+    size_t running = 0;
+    {
+        const std::lock_guard<std::mutex> lock(queue.mutex);
+        running = queue.running;
+    }
+
+    const size_t count = std::min(stats.latencyCount, latencyWindow);
+    std::vector<double> sorted(stats.latencies.begin(), stats.latencies.begin() + static_cast<std::ptrdiff_t>(count));
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](double p) {
+        return sorted.empty() ? 0.0 : sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())))];
+    };
+
+    const long long now = std::chrono::duration_cast<std::chrono::seconds>(Clock::now().time_since_epoch()).count();
+    uint64_t recent = 0;
+    for (int i = 0; i < rateSeconds; i++)
+        if (now - stats.second[i] < rateSeconds)
+            recent += stats.perSecond[i];
+
+    char line[512];
+    std::snprintf(line, sizeof(line),
+                  "STATS queue=%zu running=%zu connections=%zu received=%llu completed=%llu timeouts=%llu "
+                  "rate=%.1f/s p50=%.3fms p90=%.3fms p99=%.3fms max=%.3fms\n",
+                  queued, running, connections.size(), static_cast<unsigned long long>(stats.received),
+                  static_cast<unsigned long long>(stats.completed), static_cast<unsigned long long>(stats.timeouts),
+                  static_cast<double>(recent) / rateSeconds, percentile(0.5), percentile(0.9), percentile(0.99),
+                  sorted.empty() ? 0.0 : sorted.back());
+    return line;
+}
+
+int Daemon::run() {
+    if (pipe(wakePipe) < 0) {
+        std::perror("pipe");
+        return 1;
+    }
+    setNonBlocking(wakePipe[0]);
+    setNonBlocking(wakePipe[1]);
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    if (!listenOn(options.socketPath))
+        return 1;
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < options.threads; t++)
+        workers.emplace_back(workerLoop, std::ref(queue), std::ref(pool), std::ref(slots[t]), std::cref(options));
+
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> polled;
+    while (!stopSignal) {
+        // Coda piena: non si legge più nessuno, i clienti restano fermi in write()
+        const bool queueFull = queued >= options.queueCapacity;
+        fds.clear();
+        polled.clear();
+        fds.push_back({wakePipe[0], POLLIN, 0});
+        fds.push_back({listenFd, POLLIN, 0});
+        for (auto &[serial, connection] : connections) {
+            short events = 0;
+            if (!queueFull && !connection.readClosed && connection.in.size() < inputLimit
+                && connection.out.size() < outputLimit)
+                events |= POLLIN;
+            if (!connection.out.empty())
+                events |= POLLOUT;
+            fds.push_back({connection.fd, events, 0});
+            polled.push_back(serial);
+        }
+
+        // Un lavoro in corso può scadere: si ricontrolla spesso finché ce n'è qualcuno
+        const int timeout = queued > 0 || stats.received > stats.completed ? 10 : 1000;
+        if (poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR) {
+            std::perror("poll");
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            char drain[256];
+            while (read(wakePipe[0], drain, sizeof(drain)) > 0) {}
+        }
+        collectResults();
+        checkDeadlines();
+        if (fds[1].revents & POLLIN)
+            acceptClients();
+
+        for (size_t i = 0; i < polled.size(); i++) {
+            auto it = connections.find(polled[i]);
+            Connection &connection = it->second;
+            const short revents = fds[i + 2].revents;
+            bool keep = true;
+            if (revents & POLLIN)
+                keep = readFrom(connection);
+            // Chiusura completa del cliente: le risposte non avrebbero più dove andare
+            if (revents & (POLLHUP | POLLERR))
+                keep = false;
+            // Anche senza dati nuovi: la coda può essersi liberata per le richieste già lette
+            if (keep)
+                keep = parseRequests(connection);
+            while (keep && !connection.out.empty()) {
+                const ssize_t n = send(connection.fd, connection.out.data(), connection.out.size(), MSG_NOSIGNAL);
+                if (n > 0) {
+                    connection.out.erase(0, static_cast<size_t>(n));
+                    continue;
+                }
+                keep = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+                break;
+            }
+            if (keep && connection.readClosed && connection.inFlight == 0 && connection.out.empty()
+                && connection.in.empty())
+                keep = false;
+            if (!keep) {
+                close(connection.fd);
+                connections.erase(it);
+            }
+        }
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.stopping = true;
+    }
+    queue.ready.notify_all();
+    for (Slot &slot : slots) {
+        const std::lock_guard<std::mutex> lock(slot.mutex);
+        if (slot.solver)
+            slot.solver->requestStop();
+    }
+    for (std::thread &worker : workers)
+        worker.join();
+    for (auto &[serial, connection] : connections)
+        close(connection.fd);
+    close(listenFd);
+    unlink(options.socketPath.c_str());
+    return 0;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string flag = argv[i];
+        const char *value = argv[i + 1];
+        if (flag == "--socket")
+            options.socketPath = value;
+        else if (flag == "--threads")
+            options.threads = static_cast<unsigned>(std::max(1, std::atoi(value)));
+        else if (flag == "--queue")
+            options.queueCapacity = static_cast<size_t>(std::max(1, std::atoi(value)));
+        else if (flag == "--batch")
+            options.batch = static_cast<size_t>(std::max(1, std::atoi(value)));
+        else if (flag == "--deadline")
+            options.deadline = std::chrono::milliseconds(std::max(1, std::atoi(value)));
+        else {
+            std::fprintf(stderr, "usage: %s [--socket PATH] [--threads N] [--queue N] [--batch N] [--deadline MS]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (argc % 2 == 0) {
+        std::fprintf(stderr, "usage: %s [--socket PATH] [--threads N] [--queue N] [--batch N] [--deadline MS]\n", argv[0]);
+        return 2;
+    }
+
+    Daemon server(std::move(options));
+    return server.run();
+}
@@ -0,0 +1,400 @@
+/**
+ * @file SudokuTrace.cpp
+ * @brief Offline analyzer of the search traces written by `SudokuSolverAlgorithm::setTracing()`.
+ *
+ * Replays the events of a trace and prints:
+ * - a summary: searches, decisions, alternatives tried, conflicts, cells
+ *   placed by propagation, solutions and events per second of search;
+ * - hot cells: the cells most often branched on, with how many of their
+ *   alternatives failed right away in propagation;
+ * - a depth histogram of the alternatives tried and of the conflicts;
+ * - wasted subtrees: the largest subtrees with no solution, counted in
+ *   alternatives tried. Only maximal ones are listed (those whose parent
+ *   led to a solution, or directly under the root), so they do not overlap.
+ *
+ * Usage: SudokuTrace [--top N] TRACE
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "../libs/SearchTrace.h"
+#include "../libs/SudokuSolverAlgorithm.h"
+
+namespace {
+
+constexpr int histogramRows = 40;
+constexpr int barWidth = 50;
+
+/** Sottoalbero senza soluzioni: un'alternativa provata e tutto ciò che c'è sotto */
+struct Subtree {
+    uint64_t cell = 0;
+    uint64_t value = 0;
+    size_t depth = 0;
+    /** Alternative provate nel sottoalbero, compresa la sua */
+    uint64_t tries = 0;
+    /** Posizione nella traccia del primo evento */
+    uint64_t event = 0;
+
+    bool operator>(const Subtree &other) const { return tries > other.tries; }
+};
+
+/** Alternativa in corso di una decisione */
+struct Alternative {
+    uint64_t cell = 0;
+    uint64_t value = 0;
+    uint64_t firstTry = 0;
+    uint64_t event = 0;
+    bool solution = false;
+    /** Figli falliti: massimali solo se questa alternativa porta a una soluzione */
+    std::vector<Subtree> failed;
+};
+
+struct Frame {
+    bool open = false;
+    Alternative alternative;
+};
+
+struct CellStats {
+    uint64_t decisions = 0;
+    uint64_t tries = 0;
+    uint64_t conflicts = 0;
+};
+
+struct DepthStats {
+    uint64_t tries = 0;
+    uint64_t conflicts = 0;
+};
+
+class Analyzer {
+public:
+    explicit Analyzer(size_t top) : top(top) {}
+
+    /** @return false if the record cannot belong to a valid trace (corrupt file) */
+    bool replay(const TraceRecord &record);
+    void finish();
+    void report() const;
+
+private:
+    void push();
+    void startAlternative(uint64_t cell, uint64_t value);
+    /** Chiude l'alternativa aperta della decisione `index` */
+    void close(size_t index);
+    void pop();
+    void popAll();
+    void keep(const Subtree &subtree);
+
+    CellStats &cellAt(uint64_t cell) {
+        if (cell >= cells.size())
+            cells.resize(cell + 1);
+        return cells[cell];
+    }
+
+    size_t top;
+    unsigned short dimension = 0;
+    uint64_t events = 0;
+
+    uint64_t searches = 0;
+    uint64_t stopped = 0;
+    uint64_t decisions = 0;
+    uint64_t unitDecisions = 0;
+    uint64_t tries = 0;
+    uint64_t propagations = 0;
+    uint64_t propagated = 0;
+    uint64_t conflicts = 0;
+    uint64_t deadStates = 0;
+    uint64_t backtracks = 0;
+    uint64_t solutions = 0;
+    uint64_t elapsedMicros = 0;
+
+    std::vector<Frame> stack;
+    /** Radice: i figli falliti sotto la radice sono sempre massimali */
+    Alternative root;
+    /** Cella dell'ultima alternativa provata, a cui va il conflitto della propagazione che segue */
+    bool afterTry = false;
+    uint64_t lastCell = 0;
+
+    std::vector<CellStats> cells;
+    std::vector<DepthStats> depths;
+    /** I più grandi sottoalberi sprecati, il più piccolo in cima */
+    std::priority_queue<Subtree, std::vector<Subtree>, std::greater<>> largest;
+    uint64_t wastedTries = 0;
+    uint64_t wastedSubtrees = 0;
+};
+
+void Analyzer::push() {
+    stack.emplace_back();
+}
+
+void Analyzer::startAlternative(uint64_t cell, uint64_t value) {
+    // Ripresa senza le decisioni di prima nella traccia: serve almeno una decisione su cui provare
+    if (stack.empty())
+        push();
+    Frame &frame = stack.back();
+    if (frame.open)
+        close(stack.size() - 1);
+
+    frame.open = true;
+    frame.alternative = {cell, value, tries, events, false, {}};
+    tries++;
+    cellAt(cell).tries++;
+    if (depths.size() <= stack.size())
+        depths.resize(stack.size() + 1);
+    depths[stack.size()].tries++;
+}
+
+void Analyzer::close(size_t index) {
+    Frame &frame = stack[index];
+    Alternative &alternative = frame.alternative;
+    frame.open = false;
+
+    // Genitore: l'alternativa aperta più vicina sopra questa decisione, altrimenti la radice
+    Alternative *parent = &root;
+    for (size_t i = index; i-- > 0;) {
+        if (stack[i].open) {
+            parent = &stack[i].alternative;
+            break;
+        }
+    }
+
+    if (alternative.solution) {
+        parent->solution = true;
+        for (const Subtree &subtree : alternative.failed)
+            keep(subtree);
+    } else {
+        // Fallita: contiene i suoi figli falliti, che non sono più massimali
+        parent->failed.push_back({alternative.cell, alternative.value, index + 1, tries - alternative.firstTry,
+                                  alternative.event});
+    }
+    alternative.failed.clear();
+    alternative.failed.shrink_to_fit();
+}
+
+void Analyzer::pop() {
+    if (stack.empty())
+        return;
+    if (stack.back().open)
+        close(stack.size() - 1);
+    stack.pop_back();
+}
+
+void Analyzer::popAll() {
+    while (!stack.empty())
+        pop();
+    for (const Subtree &subtree : root.failed)
+        keep(subtree);
+    root = {};
+}
+
+void Analyzer::keep(const Subtree &subtree) {
+    wastedTries += subtree.tries;
+    wastedSubtrees++;
+    if (largest.size() < top) {
+        largest.push(subtree);
+    } else if (top > 0 && subtree.tries > largest.top().tries) {
+        largest.pop();
+        largest.push(subtree);
+    }
+}
+
+bool Analyzer::replay(const TraceRecord &record) {
+    // Celle e profondità vengono dal file: fuori dalla griglia la traccia è corrotta,
+    // e non devono dimensionare pila e tabelle
+    const uint64_t cellCount = static_cast<uint64_t>(dimension) * dimension;
+    if ((record.kind == TraceEvent::Decision || record.kind == TraceEvent::Try) && record.payload >= cellCount)
+        return false;
+
+    switch (record.kind) {
+    case TraceEvent::Begin: {
+        if (record.fields[0] == 0 || record.fields[0] > 64 || record.fields[1] > record.fields[0] * record.fields[0])
+            return false;
+        searches++;
+        dimension = static_cast<unsigned short>(record.fields[0]);
+        const auto depth = static_cast<size_t>(record.fields[1]);
+        // Ricerca nuova, o ripresa di una che la traccia non ha visto fermarsi: si riparte da qui
+        if (!record.payload || stack.size() != depth) {
+            popAll();
+            stack.resize(depth);
+        }
+        afterTry = false;
+        break;
+    }
+    case TraceEvent::Decision:
+        decisions++;
+        cellAt(record.payload).decisions++;
+        push();
+        break;
+    case TraceEvent::UnitDecision:
+        unitDecisions++;
+        push();
+        break;
+    case TraceEvent::Try:
+        startAlternative(record.payload, record.fields[0]);
+        afterTry = true;
+        lastCell = record.payload;
+        break;
+    case TraceEvent::Propagation: {
+        propagations++;
+        propagated += record.payload >> 2;
+        const auto outcome = static_cast<TraceOutcome>(record.payload & 3);
+        if (outcome != TraceOutcome::Consistent) {
+            (outcome == TraceOutcome::Conflict ? conflicts : deadStates)++;
+            if (afterTry) {
+                cellAt(lastCell).conflicts++;
+                depths[stack.size()].conflicts++;
+            }
+        }
+        afterTry = false;
+        break;
+    }
+    case TraceEvent::Backtrack:
+        backtracks += record.payload;
+        for (uint64_t i = 0; i < record.payload; i++)
+            pop();
+        break;
+    case TraceEvent::Solution:
+        solutions++;
+        for (auto frame = stack.rbegin(); frame != stack.rend(); ++frame) {
+            if (frame->open) {
+                frame->alternative.solution = true;
+                break;
+            }
+        }
+        break;
+    case TraceEvent::End:
+        elapsedMicros += record.fields[1];
+        // Una ricerca fermata resta aperta: la sua ripresa continua la stessa pila
+        if (record.payload)
+            stopped++;
+        else
+            popAll();
+        break;
+    }
+    events++;
+    return true;
+}
+
+void Analyzer::finish() {
+    popAll();
+}
+
+void Analyzer::report() const {
+    std::printf("events       %" PRIu64 "\n", events);
+    std::printf("searches     %" PRIu64 " (%" PRIu64 " stopped)\n", searches, stopped);
+    std::printf("decisions    %" PRIu64 " on cells, %" PRIu64 " on unit positions\n", decisions, unitDecisions);
+    std::printf("tries        %" PRIu64 "\n", tries);
+    std::printf("propagation  %" PRIu64 " batches, %" PRIu64 " cells placed\n", propagations, propagated);
+    std::printf("conflicts    %" PRIu64 " (+%" PRIu64 " dead states)\n", conflicts, deadStates);
+    std::printf("backtracks   %" PRIu64 "\n", backtracks);
+    std::printf("solutions    %" PRIu64 "\n", solutions);
+    if (elapsedMicros > 0)
+        std::printf("search time  %.3f s, %.2f M events/s\n", static_cast<double>(elapsedMicros) / 1e6,
+                    static_cast<double>(events) / static_cast<double>(elapsedMicros));
+
+    // Celle calde: le più diramate
+    std::vector<size_t> order;
+    for (size_t cell = 0; cell < cells.size(); cell++)
+        if (cells[cell].tries > 0)
+            order.push_back(cell);
+    const size_t shown = std::min(top, order.size());
+    std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(shown), order.end(),
+                      [this](size_t a, size_t b) { return cells[a].tries > cells[b].tries; });
+    std::printf("\nhot cells (by alternatives tried)\n");
+    std::printf("  %-8s %12s %12s %12s\n", "cell", "decisions", "tries", "conflicts");
+    for (size_t i = 0; i < shown; i++) {
+        const size_t cell = order[i];
+        const size_t width = dimension ? dimension : 1;
+        const std::string name = "r" + std::to_string(cell / width + 1) + "c" + std::to_string(cell % width + 1);
+        std::printf("  %-8s %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n", name.c_str(),
+                    cells[cell].decisions, cells[cell].tries, cells[cell].conflicts);
+    }
+
+    // Istogramma per profondità, a gruppi se le profondità sono troppe per una riga ciascuna
+    size_t deepest = 0;
+    uint64_t most = 0;
+    for (size_t depth = 0; depth < depths.size(); depth++)
+        if (depths[depth].tries > 0)
+            deepest = depth;
+    const size_t group = std::max<size_t>(1, (deepest + histogramRows - 1) / histogramRows);
+    std::vector<DepthStats> rows((deepest + group - 1) / group);
+    for (size_t depth = 1; depth <= deepest; depth++) {
+        rows[(depth - 1) / group].tries += depths[depth].tries;
+        rows[(depth - 1) / group].conflicts += depths[depth].conflicts;
+    }
+    for (const DepthStats &row : rows)
+        most = std::max(most, row.tries);
+    std::printf("\ndepth histogram (tries, conflicts)\n");
+    for (size_t i = 0; i < rows.size() && most > 0; i++) {
+        const std::string label = group == 1 ? std::to_string(i + 1)
+                                             : std::to_string(i * group + 1) + "-" + std::to_string((i + 1) * group);
+        const auto bar = static_cast<int>(static_cast<double>(rows[i].tries) * barWidth / static_cast<double>(most));
+        std::printf("  %9s %12" PRIu64 " %12" PRIu64 "  %.*s\n", label.c_str(), rows[i].tries, rows[i].conflicts,
+                    bar, "##################################################");
+    }
+
+    // Sottoalberi sprecati, dal più grande
+    auto heap = largest;
+    std::vector<Subtree> wasted;
+    while (!heap.empty()) {
+        wasted.push_back(heap.top());
+        heap.pop();
+    }
+    std::reverse(wasted.begin(), wasted.end());
+    std::printf("\nwasted subtrees: %" PRIu64 " of %" PRIu64 " tries (%.1f%%) in %" PRIu64 " subtrees\n",
+                wastedTries, tries, tries ? 100.0 * static_cast<double>(wastedTries) / static_cast<double>(tries) : 0.0,
+                wastedSubtrees);
+    std::printf("  %-8s %6s %6s %12s %14s\n", "cell", "value", "depth", "tries", "at event");
+    for (const Subtree &subtree : wasted) {
+        const size_t width = dimension ? dimension : 1;
+        const std::string name = "r" + std::to_string(subtree.cell / width + 1) + "c" + std::to_string(subtree.cell % width + 1);
+        std::printf("  %-8s %6c %6zu %12" PRIu64 " %14" PRIu64 "\n", name.c_str(),
+                    SudokuSolverAlgorithm::symbolFor(static_cast<unsigned short>(subtree.value)), subtree.depth,
+                    subtree.tries, subtree.event);
+    }
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    size_t top = 10;
+    const char *path = nullptr;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; i++) {
+        const std::string flag = argv[i];
+        if (flag == "--top" && i + 1 < argc)
+            top = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        else if (!flag.starts_with("--") && !path)
+            path = argv[i];
+        else
+            usage = true;
+    }
+    if (usage || !path) {
+        std::fprintf(stderr, "usage: %s [--top N] TRACE\n", argv[0]);
+        return 2;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    SearchTraceReader reader(in);
+    if (!reader.valid()) {
+        std::fprintf(stderr, "%s: not a search trace\n", path);
+        return 1;
+    }
+
+    Analyzer analyzer(top);
+    TraceRecord record;
+    while (reader.next(record)) {
+        if (!analyzer.replay(record)) {
+            std::fprintf(stderr, "%s: corrupt trace\n", path);
+            return 1;
+        }
+    }
+    analyzer.finish();
+    analyzer.report();
+    return 0;
+}